@@ -0,0 +1,112 @@
+#ifndef ADAPTIVE_SDF_H
+#define ADAPTIVE_SDF_H
+
+#include "sdf.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file AdaptiveSDF.h
+ * @brief Adaptively sampled distance field (quadtree ADF)
+ *
+ * The field is stored at the corners of quadtree cells and reconstructed
+ * bilinearly inside each leaf. A cell is subdivided unless the error of the
+ * bilinear reconstruction from its corners is provably within errorBound
+ * over the whole cell, not just at sample points: exact values on a probe
+ * grid (3x3, 5x5 for cells the boundary may cross) are combined with the
+ * convexity of each edge's distance function, or with the 1-Lipschitz bound
+ * of the SDF where the boundary may pass between probes. Regions where the
+ * field is nearly linear end up in large leaves, so memory follows the
+ * detail of the outline instead of the area of the domain.
+ *
+ * The tree is built one level at a time; the exact values a level needs are
+ * evaluated in parallel through an EdgeBVH. Corners that lie on the edge of
+ * a larger neighbour (T-junctions) are then snapped onto that edge's linear
+ * interpolation, which makes the field continuous across leaves and the
+ * extracted contours crack-free. Leaves are checked again with their
+ * snapped corners and the tree is refined further where that breaks the
+ * bound, so it holds for the final field.
+ */
+class AdaptiveSDF {
+public:
+    AdaptiveSDF();
+
+    /**
+     * @brief Build the quadtree for a polygon over a world region
+     *
+     * @param prepared Prepared polygon (see preparePolygon())
+     * @param worldMinX Minimum X coordinate in world space
+     * @param worldMaxX Maximum X coordinate in world space
+     * @param worldMinY Minimum Y coordinate in world space
+     * @param worldMaxY Maximum Y coordinate in world space
+     * @param errorBound Maximum reconstruction error in world units; guaranteed
+     *        everywhere except in leaves already at maxDepth
+     * @param maxDepth Maximum subdivision depth, 1..20 (default: 12)
+     * @param minDepth Depth every region is subdivided to (default: 3)
+     * @param threadCount Worker threads (0 = hardware concurrency)
+     * @return true on success
+     */
+    bool build(const PreparedPolygon& prepared,
+               float worldMinX, float worldMaxX,
+               float worldMinY, float worldMaxY,
+               float errorBound,
+               int maxDepth = 12,
+               int minDepth = 3,
+               int threadCount = 0);
+
+    /**
+     * @brief Release the tree
+     */
+    void clear();
+
+    /**
+     * @brief Check if the tree holds data
+     */
+    bool isValid() const { return !m_nodes.empty(); }
+
+    /**
+     * @brief Reconstructed SDF value at a world position
+     *
+     * Positions outside the region are clamped to its border.
+     */
+    float sample(const Point2D& point) const;
+
+    /**
+     * @brief Marching Squares over the leaves
+     *
+     * @param isoValue The SDF threshold value to extract
+     * @return Line segments (pairs of points), as extractIsoContour()
+     */
+    std::vector<Point2D> extractIsoContour(float isoValue) const;
+
+    int getNodeCount() const { return static_cast<int>(m_nodes.size()); }
+    int getLeafCount() const { return static_cast<int>(m_values.size() / 4); }
+
+    /**
+     * @brief Size of the smallest leaf in world units (X, Y)
+     */
+    void getFinestCellSize(float& outSizeX, float& outSizeY) const;
+
+    /**
+     * @brief Bytes used by nodes and leaf values
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    /**
+     * @brief Reconstruct inside a leaf, u and v in [0, 1]
+     */
+    float interpolate(int leaf, float u, float v) const;
+
+    // Root first. An entry >= 0 is the first of 4 consecutive children
+    // (bottom-left, bottom-right, top-left, top-right); leaf k is stored
+    // as -(k + 1)
+    std::vector<int> m_nodes;
+    // 4 corner values per leaf: bottom-left, bottom-right, top-right, top-left
+    std::vector<float> m_values;
+    float m_worldMinX, m_worldMaxX;
+    float m_worldMinY, m_worldMaxY;
+    int m_maxDepth;                // Deepest leaf level
+};
+
+#endif // ADAPTIVE_SDF_H
@@ -0,0 +1,128 @@
+#ifndef EDGE_BVH_H
+#define EDGE_BVH_H
+
+#include "sdf.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file EdgeBVH.h
+ * @brief Bounding volume hierarchy over polygon edges for point queries
+ *
+ * Edges are split recursively at the median centroid along the longer axis
+ * of their bounds, down to leaves of at most LEAF_SIZE edges. Leaf edges are
+ * stored contiguously in a reordered PreparedPolygon.
+ *
+ * - Distance: depth-first traversal that visits the nearer child first and
+ *   prunes every node whose box is farther than the best edge so far.
+ * - Sign: a ray cast towards +X visits only the nodes the ray can hit and
+ *   sums the winding contributions of their edges.
+ *
+ * Both use the same per-edge float operations as calculatePreparedSDF(), so
+ * results match it (signs can differ only within float rounding of the
+ * boundary). A query costs roughly O(log E) instead of O(E).
+ */
+class EdgeBVH {
+public:
+    EdgeBVH();
+
+    /**
+     * @brief Build the hierarchy over the edges of a prepared polygon
+     *
+     * O(E log E). An empty or invalid polygon gives an empty index.
+     */
+    void build(const PreparedPolygon& prepared);
+
+    /**
+     * @brief Release the hierarchy
+     */
+    void clear();
+
+    /**
+     * @brief Check if the index holds a valid polygon (>= 3 edges)
+     */
+    bool isValid() const { return m_edges.edgeCount >= 3; }
+
+    /**
+     * @brief Signed distance, same convention as calculatePreparedSDF()
+     */
+    float signedDistance(const Point2D& p) const;
+
+    /**
+     * @brief Signed distance and its unit gradient
+     *
+     * The gradient points from the nearest point on the nearest edge to p
+     * (negated inside), as in calculatePreparedSDFGradient(); on the
+     * boundary it is the outward edge normal. Ties between equally near
+     * edges may resolve to a different edge than the linear scan.
+     *
+     * @param outGradient Output: unit gradient, (0, 0) for an empty index
+     */
+    float signedDistance(const Point2D& p, Point2D& outGradient) const;
+
+    /**
+     * @brief Unsigned distance to the nearest edge
+     * @param outEdge Optional output: index of the nearest edge in the
+     *                original PreparedPolygon
+     */
+    float distance(const Point2D& p, int* outEdge = nullptr) const;
+
+    /**
+     * @brief Edges within a radius of a point
+     * @param outEdges Output: indices in the original PreparedPolygon of
+     *                 every edge at distance <= radius from p (cleared first)
+     */
+    void edgesWithin(const Point2D& p, float radius, std::vector<int>& outEdges) const;
+
+    /**
+     * @brief Inside test (nonzero winding) by ray casting through the index
+     */
+    bool isInside(const Point2D& p) const;
+
+    /**
+     * @brief Number of hierarchy nodes
+     */
+    int getNodeCount() const { return static_cast<int>(m_nodes.size()); }
+
+    /**
+     * @brief Bytes used by nodes and reordered edges
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief Duration of the last build() in milliseconds
+     */
+    double getBuildTimeMs() const { return m_buildTimeMs; }
+
+private:
+    static const int LEAF_SIZE = 4;
+
+    /**
+     * @brief Node bounds; leaves have count > 0 and own edges
+     *        [start, start + count), inner nodes have count == 0, their left
+     *        child directly follows them and start is the right child
+     */
+    struct Node {
+        float minX, minY, maxX, maxY;
+        int start;
+        int count;
+    };
+
+    /**
+     * @brief Leaf-order index of the nearest edge (-1 if none) and its
+     *        squared distance
+     */
+    int nearestEdge(const Point2D& p, float& outDistSq) const;
+
+    int buildNode(std::vector<int>& order, int begin, int end,
+                  const std::vector<float>& centerX,
+                  const std::vector<float>& centerY,
+                  const PreparedPolygon& prepared);
+
+    std::vector<Node> m_nodes;
+    PreparedPolygon m_edges;         // Edges in leaf order
+    std::vector<int> m_edgeIndex;    // Leaf order -> original edge index
+    double m_buildTimeMs;
+};
+
+#endif // EDGE_BVH_H
@@ -0,0 +1,157 @@
+#ifndef SDF_ATLAS_H
+#define SDF_ATLAS_H
+
+#include "sdf.h"
+#include <limits>
+#include <vector>
+
+/**
+ * @file SDFAtlas.h
+ * @brief Many small SDFs (icons, glyph outlines) packed into texture pages
+ *
+ * Every shape gets a region of texels sized from its bounds, padding and
+ * pixel size. Regions are packed into fixed-size pages with a skyline
+ * bottom-left packer (tallest shapes first, a new page when none fits).
+ * All pages live in one allocation, and the rows of every region are
+ * generated in a single parallel pass on the shared ThreadPool, written
+ * straight into the page by the vectorized row kernel.
+ */
+
+/**
+ * @brief Atlas layout and generation settings
+ */
+struct SDFAtlasConfig {
+    int pageWidth;       // Page width in texels (default: 1024)
+    int pageHeight;      // Page height in texels (default: 1024)
+    int spacing;         // Empty texels between regions, against filtering bleed (default: 1)
+    int threadCount;     // Generation threads, 0 = all cores (default: 0)
+    bool useSIMD;        // Use the vectorized row kernel (default: true)
+    float maxDistance;   // Clamp values to +/- maxDistance, 0 = no clamp (default: 0)
+    float emptyValue;    // Texels outside every region (default: FLT_MAX, "far outside")
+
+    SDFAtlasConfig()
+        : pageWidth(1024), pageHeight(1024), spacing(1), threadCount(0), useSIMD(true),
+          maxDistance(0.0f), emptyValue(std::numeric_limits<float>::max()) {}
+};
+
+/**
+ * @brief One shape to place in the atlas
+ */
+struct SDFAtlasShape {
+    std::vector<Point2D> polygon;
+    float pixelSize;  // World units per texel (default: 0.1)
+    float padding;    // Extra margin around the polygon bounds, world units (default: 0.5)
+
+    SDFAtlasShape() : pixelSize(0.1f), padding(0.5f) {}
+};
+
+/**
+ * @brief Where a shape ended up and how to address it
+ *
+ * Texel (x + i, y + j) of the page holds the SDF sampled at world position
+ * (minX + (i + 0.5) * pixelSize, minY + (j + 0.5) * pixelSize), i.e. at the
+ * texel center. A world position maps to continuous texel coordinates
+ * (origin at the page corner) by
+ *   texelX = worldX * scale + offsetX, texelY = worldY * scale + offsetY
+ * and to page UVs by dividing by the page size. Row 0 of a page is its
+ * bottom row (v = 0), as uploaded by glTexImage2D.
+ */
+struct SDFAtlasRegion {
+    int page;                     // Page index, -1 if the shape was not placed
+    int x, y;                     // Lower-left texel of the region in the page
+    int width, height;            // Region size in texels
+    float u0, v0, u1, v1;         // UV rectangle of the region (texel edges)
+    float scale;                  // World-to-texel scale, 1 / pixelSize
+    float offsetX, offsetY;       // World-to-texel offsets
+    float minX, maxX;             // World extent covered by the region
+    float minY, maxY;
+    bool isValid;                 // Polygon valid and region placed
+
+    SDFAtlasRegion()
+        : page(-1), x(0), y(0), width(0), height(0), u0(0.0f), v0(0.0f), u1(0.0f), v1(0.0f),
+          scale(0.0f), offsetX(0.0f), offsetY(0.0f), minX(0.0f), maxX(0.0f), minY(0.0f),
+          maxY(0.0f), isValid(false) {}
+};
+
+/**
+ * @brief Builds SDF texture atlases
+ *
+ * Usage example:
+ * @code
+ *   std::vector<SDFAtlasShape> shapes(outlines.size());
+ *   for (size_t i = 0; i < outlines.size(); i++) {
+ *       shapes[i].polygon = outlines[i];
+ *       shapes[i].pixelSize = 0.01f;
+ *       shapes[i].padding = 0.04f;
+ *   }
+ *
+ *   SDFAtlas atlas;
+ *   atlas.build(shapes);
+ *   for (int page = 0; page < atlas.getPageCount(); page++)
+ *       uploadTexture(atlas.getPage(page), atlas.getPageWidth(), atlas.getPageHeight());
+ *   const SDFAtlasRegion& region = atlas.getRegions()[i];  // UVs of shape i
+ * @endcode
+ */
+class SDFAtlas {
+public:
+    /**
+     * @brief Constructor
+     * @param config Page size, spacing and generation settings
+     */
+    SDFAtlas(const SDFAtlasConfig& config = SDFAtlasConfig());
+
+    /**
+     * @brief Pack and generate the atlas, replacing the previous one
+     *
+     * Samples of each region are the same, bit for bit, as generateSDFGrid()
+     * with the Exact method over the region's world extent (then clamped
+     * to maxDistance if set). Shapes with fewer than 3 points, a
+     * non-positive pixel size or a region larger than a page are skipped
+     * (their region is invalid).
+     *
+     * @param shapes Polygons with their pixel size and padding
+     * @return true if every shape was placed
+     */
+    bool build(const std::vector<SDFAtlasShape>& shapes);
+
+    /**
+     * @brief Regions of the last build, in shape order
+     */
+    const std::vector<SDFAtlasRegion>& getRegions() const { return m_regions; }
+
+    /**
+     * @brief Number of pages of the last build
+     */
+    int getPageCount() const { return m_pageCount; }
+
+    int getPageWidth() const { return m_pageWidth; }
+    int getPageHeight() const { return m_pageHeight; }
+
+    /**
+     * @brief Row-major texels of one page, pageWidth * pageHeight floats
+     */
+    const float* getPage(int page) const;
+
+    /**
+     * @brief Fraction of the page area covered by regions (0..1)
+     */
+    float getOccupancy() const;
+
+    /**
+     * @brief Wall time of the last build() in milliseconds
+     */
+    double getLastBuildTimeMs() const { return m_lastBuildTimeMs; }
+
+    void setConfig(const SDFAtlasConfig& config) { m_config = config; }
+    const SDFAtlasConfig& getConfig() const { return m_config; }
+
+private:
+    SDFAtlasConfig m_config;
+    std::vector<float> m_texels;  // All pages, one after the other
+    std::vector<SDFAtlasRegion> m_regions;
+    int m_pageCount;
+    int m_pageWidth, m_pageHeight;  // Of the last build
+    double m_lastBuildTimeMs;
+};
+
+#endif // SDF_ATLAS_H
@@ -0,0 +1,115 @@
+#ifndef SDF_BATCH_PROCESSOR_H
+#define SDF_BATCH_PROCESSOR_H
+
+#include "SDFProcessor.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @file SDFBatchProcessor.h
+ * @brief Grid, contour and ring generation for many polygons in one job
+ *
+ * Items are scheduled on the shared ThreadPool, whose threads claim tasks
+ * dynamically. The cost of every item is estimated from its grid size and
+ * edge count (samples x edges for Exact, samples otherwise):
+ * - Large items get a task of their own and generate their grid with
+ *   config.threadCount threads, split into row bands. Threads that run out
+ *   of work pick up bands of the large items still running.
+ * - Small items are grouped into tasks of similar total cost and run
+ *   serially inside their task, one SDFProcessor per task.
+ * Tasks start in order of decreasing cost, so a skewed job does not end
+ * with one thread working on a huge polygon that started last.
+ */
+
+/**
+ * @brief Operations to run on a batch item (bit flags)
+ */
+enum SDFBatchOperation {
+    SDFBatchGrid = 1,     // Keep the generated grid (SDFBatchItemResult::grid)
+    SDFBatchContour = 2,  // extractContour(contourThreshold)
+    SDFBatchRing = 4      // generateRing(ringOuterThreshold, ringInnerThreshold)
+};
+
+/**
+ * @brief One polygon and the operations to run on it
+ */
+struct SDFBatchItem {
+    std::vector<Point2D> polygon;
+    unsigned operations;       // SDFBatchOperation flags
+    float contourThreshold;    // For SDFBatchContour (default: 0)
+    float ringOuterThreshold;  // For SDFBatchRing (default: 0.2)
+    float ringInnerThreshold;  // For SDFBatchRing (default: 0)
+
+    SDFBatchItem()
+        : operations(SDFBatchContour), contourThreshold(0.0f),
+          ringOuterThreshold(0.2f), ringInnerThreshold(0.0f) {}
+};
+
+/**
+ * @brief Result of one batch item
+ */
+struct SDFBatchItemResult {
+    std::shared_ptr<const SDFGridSnapshot> grid;  // SDFBatchGrid only
+    ContourResult contour;                         // SDFBatchContour only
+    RingResult ring;                               // SDFBatchRing only
+    double timeMs;                                 // Wall time spent on this item
+    bool isValid;                                  // Polygon valid and every operation succeeded
+};
+
+/**
+ * @brief Runs SDFProcessor operations on many polygons in parallel
+ *
+ * Usage example:
+ * @code
+ *   std::vector<SDFBatchItem> items(polygons.size());
+ *   for (size_t i = 0; i < polygons.size(); i++) {
+ *       items[i].polygon = polygons[i];
+ *       items[i].operations = SDFBatchContour | SDFBatchRing;
+ *   }
+ *
+ *   SDFBatchProcessor batch(config);
+ *   std::vector<SDFBatchItemResult> results = batch.process(items);
+ * @endcode
+ */
+class SDFBatchProcessor {
+public:
+    /**
+     * @brief Constructor
+     * @param config Configuration used for every item (threadCount bounds
+     *               the threads used by the whole job)
+     */
+    SDFBatchProcessor(const SDFConfig& config = SDFConfig());
+
+    /**
+     * @brief Process every item
+     *
+     * Each result is the same as running a fresh SDFProcessor with the
+     * batch config on the item.
+     *
+     * @param items Polygons and operations
+     * @return One result per item, in input order
+     */
+    std::vector<SDFBatchItemResult> process(const std::vector<SDFBatchItem>& items);
+
+    /**
+     * @brief Wall time of the last process() call in milliseconds
+     */
+    double getLastJobTimeMs() const { return m_lastJobTimeMs; }
+
+    /**
+     * @brief Number of tasks the last process() call was split into
+     */
+    int getLastTaskCount() const { return m_lastTaskCount; }
+
+    void setConfig(const SDFConfig& config) { m_config = config; }
+    const SDFConfig& getConfig() const { return m_config; }
+
+private:
+    double estimateCost(const std::vector<Point2D>& polygon) const;
+
+    SDFConfig m_config;
+    double m_lastJobTimeMs;
+    int m_lastTaskCount;
+};
+
+#endif // SDF_BATCH_PROCESSOR_H
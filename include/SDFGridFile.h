@@ -0,0 +1,204 @@
+#ifndef SDF_GRID_FILE_H
+#define SDF_GRID_FILE_H
+
+#include "SDFGridSnapshot.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file SDFGridFile.h
+ * @brief Binary file format for dense SDF grids
+ *
+ * Layout (version 2, native little-endian):
+ * - 128-byte header: magic "SDFGRID", version, byte-order mark, value
+ *   type, width, height, world bounds, compression, tile size, and the
+ *   generation parameters (grid method, gridSize, padding, maxDistance,
+ *   maxGridSize), then the offset and size of the data and the hash of the
+ *   polygon (SDFGridFile::hashPolygon()). Version 1 files have the same
+ *   layout without the hash; they are still read, with polygonHash 0.
+ * - Data at an offset aligned to 64 bytes:
+ *   - None: width * height floats, row-major. Such files can be mapped and
+ *     used in place (SDFGridFile::map()).
+ *   - Tiles: a table of tileCount + 1 uint64 offsets (relative to the data
+ *     offset), then one independently compressed stream per tile. Each
+ *     sample is XORed with its left neighbour (first column: the sample
+ *     above), the 4 byte planes are stored one after the other and every
+ *     plane is PackBits run-length coded. Lossless; the smooth high bytes
+ *     and the clamped regions of narrow-band grids compress well.
+ *
+ * Sparse and quantized grids cannot be written. SDFGridFileWriter writes
+ * uncompressed files row by row.
+ */
+
+/**
+ * @brief Sample type stored in a grid file
+ */
+enum class SDFGridValueType {
+    Float32
+};
+
+/**
+ * @brief Payload encoding of a grid file
+ */
+enum class SDFGridCompression {
+    None,  // Raw samples, can be memory-mapped
+    Tiles  // Per-tile compressed, decoded on load
+};
+
+/**
+ * @brief Contents of a grid file header
+ */
+struct SDFGridFileInfo {
+    int version;
+    int width, height;
+    float minX, maxX;
+    float minY, maxY;
+    SDFGridValueType valueType;
+    SDFGridCompression compression;
+    int tileSize;               // Tiles only
+
+    // Parameters the grid was generated with
+    SDFGridMethod gridMethod;
+    float gridSize;
+    float padding;
+    float maxDistance;
+    int maxGridSize;
+    uint64_t polygonHash;       // SDFGridFile::hashPolygon() of the polygon (version >= 2)
+
+    SDFGridFileInfo()
+        : version(0), width(0), height(0), minX(0.0f), maxX(0.0f), minY(0.0f), maxY(0.0f),
+          valueType(SDFGridValueType::Float32), compression(SDFGridCompression::None),
+          tileSize(0), gridMethod(SDFGridMethod::Exact), gridSize(0.0f), padding(0.0f),
+          maxDistance(0.0f), maxGridSize(0), polygonHash(0) {}
+};
+
+/**
+ * @brief Writers and loaders for the grid file format
+ */
+class SDFGridFile {
+public:
+    /**
+     * @brief Write a dense grid
+     *
+     * Size, bounds and samples come from grid; the generation parameters
+     * and the compression settings (compression, tileSize) from info.
+     * The file is written next to path and renamed over it, so mappings of
+     * an existing file at path (even the one grid comes from) keep their
+     * contents.
+     *
+     * @param path Output file
+     * @param grid Dense grid to write
+     * @param info Generation parameters and compression settings
+     * @return false on a sparse or quantized grid or an I/O error
+     */
+    static bool write(const std::string& path, const SDFGridSnapshot& grid,
+                      const SDFGridFileInfo& info);
+
+    /**
+     * @brief 64-bit FNV-1a hash of the polygon's vertex coordinates
+     *
+     * Identifies the polygon a file was generated for: grids of different
+     * polygons can share their size and bounds.
+     */
+    static uint64_t hashPolygon(const std::vector<Point2D>& polygon);
+
+    /**
+     * @brief Read and validate the header only
+     */
+    static bool readInfo(const std::string& path, SDFGridFileInfo& info);
+
+    /**
+     * @brief Load a grid into memory, decoding tiles in parallel
+     * @param path Input file
+     * @param info Optional output header contents
+     * @return Snapshot, or nullptr on error
+     */
+    static std::shared_ptr<const SDFGridSnapshot> load(const std::string& path,
+                                                       SDFGridFileInfo* info = nullptr);
+
+    /**
+     * @brief Map an uncompressed grid file without copying it
+     *
+     * The snapshot's samples point into the mapping, which is released
+     * with the last reference to the snapshot. Pages are read on first
+     * access, so opening takes about as long as reading the header.
+     *
+     * @param path Input file (SDFGridCompression::None)
+     * @param info Optional output header contents
+     * @return Snapshot, or nullptr on error or compressed files
+     */
+    static std::shared_ptr<const SDFGridSnapshot> map(const std::string& path,
+                                                      SDFGridFileInfo* info = nullptr);
+
+private:
+    static std::shared_ptr<SDFGridSnapshot> makeSnapshot(int width, int height,
+                                                         float minX, float maxX,
+                                                         float minY, float maxY);
+};
+
+/**
+ * @brief Writes an uncompressed grid file row by row
+ *
+ * Only the rows passed to writeRows() are in memory, so grids larger than
+ * memory can be written, e.g. as the sink of generateSDFGridStripes():
+ * @code
+ *   SDFGridFileWriter writer;
+ *   writer.open(path, width, height, minX, maxX, minY, maxY, info);
+ *   generateSDFGridStripes(width, height, minX, maxX, minY, maxY, prepared, 256,
+ *       [&](int rowBegin, int rowCount, const float* rows) {
+ *           return writer.writeRows(rowBegin, rowCount, rows);
+ *       });
+ *   writer.close();
+ * @endcode
+ * The result can be used with SDFGridFile::map(). Rows go to a temporary
+ * file that replaces path on a successful close(), as in SDFGridFile::write().
+ */
+class SDFGridFileWriter {
+public:
+    SDFGridFileWriter();
+    ~SDFGridFileWriter();
+
+    /**
+     * @brief Create the file and write its header
+     * @param info Generation parameters (the compression settings are ignored)
+     * @return false on an invalid size or an I/O error
+     */
+    bool open(const std::string& path, int width, int height,
+              float minX, float maxX, float minY, float maxY,
+              const SDFGridFileInfo& info);
+
+    /**
+     * @brief Append rows; each row must be written once, in order
+     * @param rowBegin Index of the first row (the number of rows written so far)
+     * @param rowCount Number of rows
+     * @param rows Row-major samples, rowCount * width floats
+     * @return false on out-of-order rows or an I/O error
+     */
+    bool writeRows(int rowBegin, int rowCount, const float* rows);
+
+    /**
+     * @brief Close the file and move it to the path given to open()
+     * @return false if rows are missing or on an I/O error (path is then
+     *         left unchanged)
+     */
+    bool close();
+
+    /**
+     * @brief Number of rows written so far
+     */
+    int getRowsWritten() const { return m_rowsWritten; }
+
+private:
+    void discard();
+
+    std::ofstream m_file;
+    std::string m_path;
+    std::string m_temporaryPath;
+    int m_width, m_height;
+    int m_rowsWritten;
+};
+
+#endif // SDF_GRID_FILE_H
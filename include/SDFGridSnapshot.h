@@ -0,0 +1,335 @@
+#ifndef SDF_GRID_SNAPSHOT_H
+#define SDF_GRID_SNAPSHOT_H
+
+#include "sdf.h"
+#include "SparseSDFGrid.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file SDFGridSnapshot.h
+ * @brief Immutable SDF grid shared between threads
+ *
+ * SDFProcessor publishes every grid it generates as a snapshot held by
+ * std::shared_ptr<const SDFGridSnapshot>. A snapshot never changes after
+ * it is published: any number of threads can extract contours and rings
+ * from it at the same time, and it stays alive as long as one of them
+ * holds it, even after the processor has published a newer grid.
+ */
+
+/**
+ * @brief Result structure for contour extraction
+ */
+struct ContourResult {
+    std::vector<Point2D> orderedPoints;  // Ordered contour points (closed loop)
+    std::vector<Point2D> lineSegments;   // Line segments for rendering (GL_LINES)
+    std::vector<IsoContour> contours;    // Every loop and open polyline, with orientation and nesting
+    bool isValid;                         // Whether extraction succeeded
+};
+
+/**
+ * @brief Result structure for ring generation
+ */
+struct RingResult {
+    std::vector<Point2D> triangleVertices;  // Triangle vertices for rendering (GL_TRIANGLES)
+    int triangleCount;                       // Number of triangles
+    std::vector<Point2D> outerContour;      // Outer contour points
+    std::vector<Point2D> innerContour;      // Inner contour points
+    bool isValid;                            // Whether generation succeeded
+};
+
+/**
+ * @brief Which ContourResult fields the buffer form of extractContour() fills
+ *
+ * Fields not selected are left empty (their capacity is kept).
+ */
+enum SDFContourOutput {
+    SDFContourPoints = 1,     // orderedPoints
+    SDFContourSegments = 2,   // lineSegments
+    SDFContourPolylines = 4,  // contours
+    SDFContourAll = 7
+};
+
+/**
+ * @brief Which RingResult fields the buffer form of generateRing() fills
+ */
+enum SDFRingOutput {
+    SDFRingTriangles = 1,  // triangleVertices and triangleCount
+    SDFRingContours = 2,   // outerContour and innerContour
+    SDFRingAll = 3
+};
+
+/**
+ * @brief Sample format of a dense grid
+ *
+ * UNorm formats store each sample clamped to [-range, range] as a linear
+ * code, value = code * step - range with step = 2 * range / (2^bits - 1),
+ * and are unpacked to floats (SIMD) whenever the grid is read. Rounding
+ * moves each sample by at most step / 2, so a contour at a threshold
+ * inside (-range, range) moves by at most step / 2 along the normal
+ * (where |gradient| = 1) on top of the Marching Squares error of the
+ * float grid: range / 255 for UNorm8, range / 65535 for UNorm16. Values
+ * within step / 2 of zero may change sign. Thresholds outside the range
+ * find only the clamped plateau.
+ */
+enum class SDFValueFormat {
+    Float32,  // 4 bytes per sample
+    UNorm16,  // 2 bytes per sample
+    UNorm8    // 1 byte per sample
+};
+
+/**
+ * @brief Interpolation of grid samples for point queries
+ *
+ * With h the sample spacing and exact samples, the interpolated value is
+ * within h * sqrt(2) / 2 (Bilinear) or 1.38 * h (CatmullRom) of the value
+ * at the point, whatever the shape: the SDF is 1-Lipschitz and the
+ * weights times the distances to their samples sum to at most that. The
+ * error is far smaller where the field is smooth: it is linear across the
+ * middle of edges (both modes reproduce it up to rounding) and curved
+ * only around vertices and along the medial axis.
+ *
+ * The bound is relative to the stored samples. An error e in the samples
+ * adds up to e (Bilinear) or 1.57 * e (CatmullRom, whose weights sum to
+ * 1.5625 in absolute value). Exact and CharacteristicScan grids store
+ * exact samples inside their band; DistanceTransform samples may be up to
+ * ~1 cell too large (see SDFGridMethod); quantized grids add their step
+ * / 2 (see SDFValueFormat).
+ */
+enum class SDFInterpolation {
+    Bilinear,   // 2 x 2 samples, continuous value, piecewise constant gradient
+    CatmullRom  // 4 x 4 samples, continuous value and gradient
+};
+
+/**
+ * @brief One generated SDF grid, dense or sparse, and its world extent
+ *
+ * Created by SDFProcessor only. Every member function is const and safe
+ * to call from several threads at once; results match the SDFProcessor
+ * functions of the same name for the grid the snapshot was taken from
+ * (no contour cache is involved).
+ */
+class SDFGridSnapshot {
+public:
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    /**
+     * @brief Get the world-space extent of the grid
+     */
+    void getBounds(float& outMinX, float& outMaxX,
+                   float& outMinY, float& outMaxY) const;
+
+    /**
+     * @brief Row-major samples of a dense Float32 grid, nullptr otherwise
+     *
+     * The samples may live in a memory-mapped file (see SDFGridFile::map()).
+     * Quantized grids are read through getCodes() or unpackRows().
+     */
+    const float* getData() const
+    {
+        return (m_sparse || m_format != SDFValueFormat::Float32) ? nullptr : m_samples;
+    }
+
+    /**
+     * @brief Sample format of a dense grid (Float32 for sparse grids)
+     */
+    SDFValueFormat getValueFormat() const { return m_format; }
+
+    /**
+     * @brief Row-major codes of a quantized grid (uint8 or uint16), nullptr otherwise
+     */
+    const void* getCodes() const;
+
+    /**
+     * @brief Dequantization of the codes: value = code * outScale + outOffset
+     */
+    void getQuantization(float& outScale, float& outOffset) const;
+
+    /**
+     * @brief Unpack rows of a dense grid to floats
+     *
+     * Float32 rows are copied; quantized rows are unpacked with the
+     * vectorized kernel of the running CPU.
+     *
+     * @param rowBegin First row
+     * @param rowCount Number of rows
+     * @param out Output, rowCount * width floats
+     */
+    void unpackRows(int rowBegin, int rowCount, float* out) const;
+
+    /**
+     * @brief Bilinearly interpolated SDF value at a world position
+     *
+     * Sample (x, y) sits at the center of its cell, as generated; positions
+     * outside the sample area are clamped to the border samples. Quantized
+     * grids are read directly from their codes.
+     */
+    float sample(const Point2D& point) const;
+
+    /**
+     * @brief Bilinearly interpolated SDF values for an array of points
+     */
+    void sample(const Point2D* points, size_t count, float* out) const;
+
+    /**
+     * @brief Interpolated SDF value and gradient, where the grid determines them
+     *
+     * Fails instead of clamping: outside the area where every sample the
+     * interpolation needs exists (between the border sample centers, one
+     * sample further in for CatmullRom), and where one of those samples
+     * is clamped (see getClampDistance()).
+     *
+     * @param point World position
+     * @param interpolation Bilinear or CatmullRom
+     * @param outValue Interpolated value
+     * @param outGradient Optional gradient of the interpolant (world units,
+     *                    close to unit length but not normalized)
+     * @return false if the grid cannot answer for this point
+     */
+    bool sample(const Point2D& point, SDFInterpolation interpolation,
+                float& outValue, Point2D* outGradient = nullptr) const;
+
+    /**
+     * @brief Magnitude from which samples may be clamped
+     *
+     * maxDistance for CharacteristicScan and Sparse storage, one
+     * quantization step below the range for quantized grids, and FLT_MAX
+     * when nothing is clamped.
+     */
+    float getClampDistance() const { return m_clampDistance; }
+
+    /**
+     * @brief Check if the samples are mapped from a file instead of owned
+     */
+    bool isMapped() const { return m_mapping != nullptr; }
+
+    /**
+     * @brief Bricks of a sparse grid, nullptr for a dense one
+     */
+    const SparseSDFGrid* getSparseGrid() const { return m_sparse ? &m_sparseGrid : nullptr; }
+
+    /**
+     * @brief Bytes used by the samples (or bricks)
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief Extract an iso-contour at a specific threshold
+     *
+     * Dense float grids are traced (traceIsoContours(), seed scan on the
+     * config.threadCount the grid was published with), sparse grids run
+     * banded Marching Squares on the same threads, quantized grids are
+     * traced row by row on the calling thread.
+     */
+    ContourResult extractContour(float threshold) const;
+
+    /**
+     * @brief Extract an iso-contour into a caller-owned result
+     *
+     * @param threshold SDF threshold value (0.0 = boundary)
+     * @param out Result to fill (isValid is always set)
+     * @param outputs SDFContourOutput flags
+     * @return out.isValid
+     */
+    bool extractContour(float threshold, ContourResult& out,
+                        unsigned outputs = SDFContourAll) const;
+
+    /**
+     * @brief Extract iso-contours at several thresholds
+     *
+     * A dense grid is swept once for all thresholds.
+     *
+     * @param thresholds SDF threshold values, any order
+     * @return One ContourResult per threshold, in the same order
+     */
+    std::vector<ContourResult> extractContours(const std::vector<float>& thresholds) const;
+
+    /**
+     * @brief Generate a ring region between two thresholds
+     */
+    RingResult generateRing(float outerThreshold, float innerThreshold) const;
+
+    /**
+     * @brief Generate a ring region into a caller-owned result
+     *
+     * @param outerThreshold Outer contour threshold (should be > innerThreshold)
+     * @param innerThreshold Inner contour threshold
+     * @param out Result to fill (isValid is always set)
+     * @param outputs SDFRingOutput flags
+     * @return out.isValid
+     */
+    bool generateRing(float outerThreshold, float innerThreshold, RingResult& out,
+                      unsigned outputs = SDFRingAll) const;
+
+private:
+    friend class SDFProcessor;
+    friend class SDFGridFile;
+
+    SDFGridSnapshot();
+
+    /**
+     * @brief Copy the selected fields of a contour result into out
+     *
+     * Vector assignment reuses the capacity already in out.
+     */
+    static void copyOutputs(const ContourResult& source, ContourResult& out,
+                            unsigned outputs);
+
+    /**
+     * @brief Trace the contours of a quantized grid, one per level
+     *
+     * Rows are unpacked a block at a time and fed to one
+     * StreamingContourTracer per level, so the float grid never exists;
+     * the result equals traceIsoContours() on the unpacked grid.
+     */
+    std::vector<std::vector<IsoContour> > traceQuantized(const std::vector<float>& levels) const;
+
+    /**
+     * @brief Unpacked value of sample (x, y) of a dense grid
+     */
+    float denseValue(int x, int y) const;
+
+    /**
+     * @brief Copy the Size x Size samples from (x0, y0) on, row-major
+     * @return false if one of them may be clamped (see getClampDistance())
+     */
+    template <int Size>
+    bool gatherSamples(int x0, int y0, float* out) const;
+
+    /**
+     * @brief Value of sample (x, y), dense or sparse
+     */
+    float gridValue(int x, int y) const
+    {
+        return m_sparse ? m_sparseGrid.getValue(x, y) : denseValue(x, y);
+    }
+
+    /**
+     * @brief Triangulate two contours already copied into out
+     *
+     * out.outerContour / out.innerContour hold the contour points; they
+     * are cleared unless SDFRingContours is requested.
+     */
+    static bool triangulate(RingResult& out, unsigned outputs,
+                            std::vector<Point2D>& resampledOuter,
+                            std::vector<Point2D>& resampledInner);
+
+    std::vector<float> m_data;    // Owned dense samples, row-major
+    const float* m_samples;       // Dense samples: m_data or a mapped file
+    std::shared_ptr<const void> m_mapping;  // Keeps a mapped file alive
+    SDFValueFormat m_format;      // Dense sample format
+    std::vector<unsigned char> m_codes8;    // UNorm8 codes, row-major
+    std::vector<unsigned short> m_codes16;  // UNorm16 codes, row-major
+    float m_codeScale, m_codeOffset;        // value = code * scale + offset
+    float m_clampDistance;        // Samples this large may be clamped
+    SparseSDFGrid m_sparseGrid;   // Sparse bricks
+    bool m_sparse;
+    int m_width, m_height;
+    float m_minX, m_maxX;
+    float m_minY, m_maxY;
+    int m_threadCount;            // Threads for contour extraction (config.threadCount)
+};
+
+#endif // SDF_GRID_SNAPSHOT_H
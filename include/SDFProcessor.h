@@ -2,6 +2,15 @@
 #define SDF_PROCESSOR_H
 
 #include "sdf.h"
+#include "SparseSDFGrid.h"
+#include "SDFGridSnapshot.h"
+#include "EdgeBVH.h"
+#include "SDFGridFile.h"
+#include "SDFStreaming.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
 #include <vector>
 
 /**
@@ -16,26 +25,44 @@
  * 
  * External users don't need to know about internal details like
  * Marching Squares, line segment connection, or resampling algorithms.
+ * 
+ * Threading: the processor itself is used from one thread at a time, but
+ * getGridSnapshot() may be called from any thread. Generated grids are
+ * published as immutable SDFGridSnapshots that any number of threads can
+ * extract contours and rings from concurrently.
+ */
+
+/**
+ * @brief Rectangle of grid samples
  */
+struct SDFTileRect {
+    int x, y;            // First sample column / row
+    int width, height;   // Size in samples
+};
 
 /**
- * @brief Result structure for contour extraction
+ * @brief Result structure for incremental grid updates
  */
-struct ContourResult {
-    std::vector<Point2D> orderedPoints;  // Ordered contour points (closed loop)
-    std::vector<Point2D> lineSegments;   // Line segments for rendering (GL_LINES)
-    bool isValid;                         // Whether extraction succeeded
+struct SDFUpdateResult {
+    std::vector<SDFTileRect> changedTiles;  // Tiles whose samples changed (row-major order)
+    int changedSamples;                      // Number of samples that changed
+    bool fullRegeneration;                   // Whole grid was rebuilt: re-upload everything
+    bool isValid;                            // Whether the edit was applied
 };
 
 /**
- * @brief Result structure for ring generation
+ * @brief How the cached SDF grid is stored
+ * 
+ * - Dense: one sample per grid point, stored as config.valueFormat
+ *   (float, or 16/8-bit codes quantized during generation, see
+ *   SDFValueFormat for the contour error).
+ * - Sparse: narrow-band bricks (see SparseSDFGrid), band half-width
+ *   maxDistance. Samples in the band are computed exactly (gridMethod is
+ *   not used); contours need |threshold| < maxDistance.
  */
-struct RingResult {
-    std::vector<Point2D> triangleVertices;  // Triangle vertices for rendering (GL_TRIANGLES)
-    int triangleCount;                       // Number of triangles
-    std::vector<Point2D> outerContour;      // Outer contour points
-    std::vector<Point2D> innerContour;      // Inner contour points
-    bool isValid;                            // Whether generation succeeded
+enum class SDFStorage {
+    Dense,
+    Sparse
 };
 
 /**
@@ -46,9 +73,23 @@ struct SDFConfig {
     float padding;       // Extra padding around polygon (default: 0.5)
     int maxGridSize;     // Maximum grid dimension (default: 512)
     int resamplePoints;  // Target points for resampling (default: 64)
+    int threadCount;     // Grid generation and contour extraction threads, 0 = all cores (default: 0)
+    bool useSIMD;        // Vectorized grid kernel (default: true)
+    SDFGridMethod gridMethod;  // Grid algorithm (default: Exact)
+    float maxDistance;   // Band half-width for CharacteristicScan and Sparse storage (default: 0.5)
+    SDFStorage storage;  // Grid storage (default: Dense)
+    int brickSize;       // Brick edge length in samples for Sparse storage (default: 8)
+    int tileSize;        // Tile edge length in samples reported by moveVertex() (default: 32)
+    int contourCacheSize;  // Contours kept by threshold for reuse, 0 = no cache (default: 16)
+    SDFValueFormat valueFormat;  // Sample format of Dense grids (default: Float32)
+    float quantizeRange; // Clamp range +/- of UNorm formats, 0 = maxDistance (default: 0)
     
     SDFConfig() 
-        : gridSize(0.1f), padding(0.5f), maxGridSize(512), resamplePoints(64) {}
+        : gridSize(0.1f), padding(0.5f), maxGridSize(512), resamplePoints(64),
+          threadCount(0), useSIMD(true), gridMethod(SDFGridMethod::Exact),
+          maxDistance(0.5f), storage(SDFStorage::Dense), brickSize(8),
+          tileSize(32), contourCacheSize(16), valueFormat(SDFValueFormat::Float32),
+          quantizeRange(0.0f) {}
 };
 
 /**
@@ -93,28 +134,354 @@ public:
      */
     const std::vector<Point2D>& getPolygon() const { return m_polygon; }
     
+    /**
+     * @brief Move one polygon vertex and update the cached grid in place
+     * 
+     * Only the two edges at the vertex change, so only samples whose
+     * nearest edge or sign can change are recomputed: samples within their
+     * stored distance of the old or new edges, and samples in the region
+     * swept by the edges. The result matches a full regeneration.
+     * 
+     * The grid is rebuilt instead (fullRegeneration) when its extent or
+     * size changes (the vertex moved the polygon bounds), for Sparse
+     * storage, quantized value formats or grid methods other than Exact.
+     * If no grid is cached yet,
+     * only the polygon is updated.
+     * 
+     * @param index Vertex index
+     * @param newPosition New vertex position
+     * @return Changed tiles (config.tileSize samples square) to re-upload
+     */
+    SDFUpdateResult moveVertex(int index, const Point2D& newPosition);
+    
+    /**
+     * @brief Get the dense SDF grid, generating it if needed
+     * 
+     * The samples belong to the current snapshot and stay valid until the
+     * grid is regenerated; hold getGridSnapshot() to keep them longer.
+     * 
+     * @param outWidth Output grid width in samples
+     * @param outHeight Output grid height in samples
+     * @return Row-major samples, or nullptr (no polygon, Sparse storage
+     *         or a quantized valueFormat; see SDFGridSnapshot::unpackRows())
+     */
+    const float* getSDFGrid(int& outWidth, int& outHeight);
+    
+    /**
+     * @brief Get the last published grid; safe to call from any thread
+     * 
+     * The snapshot is immutable: readers on other threads can extract
+     * contours and rings from it while this processor regenerates. Each
+     * regeneration (on demand, or through updateGridSnapshot()) publishes
+     * a new snapshot atomically; readers still holding the old one finish
+     * on it and it is freed with its last reference. After setPolygon(),
+     * setConfig() or moveVertex() the previous grid stays published until
+     * the new one is generated.
+     * 
+     * @return Snapshot, or nullptr if no grid has been generated
+     */
+    std::shared_ptr<const SDFGridSnapshot> getGridSnapshot() const;
+    
+    /**
+     * @brief Generate the grid if it is out of date and publish it
+     * @return The current snapshot, or nullptr (no polygon)
+     */
+    std::shared_ptr<const SDFGridSnapshot> updateGridSnapshot();
+    
+    /**
+     * @brief Write the grid (generated if out of date) to a grid file
+     * 
+     * The file records the generation parameters, so loadGrid() can tell
+     * whether it still matches the polygon and config. It is written to a
+     * temporary file and renamed over path, so grids mapped from an older
+     * file at path stay intact. The file the current grid is mapped from
+     * is never overwritten: it already holds this grid.
+     * 
+     * @param path Output file
+     * @param compression None (mappable) or Tiles (smaller, decoded on load)
+     * @param tileSize Tile edge length in samples for Tiles
+     * @return false without a polygon, with Sparse storage or a quantized
+     *         valueFormat, when path is the file the current grid is mapped
+     *         from, or on I/O errors
+     */
+    bool saveGrid(const std::string& path,
+                  SDFGridCompression compression = SDFGridCompression::None,
+                  int tileSize = 64);
+    
+    /**
+     * @brief Use a grid file instead of generating the grid
+     * 
+     * The file must have been saved for the current polygon (same vertices,
+     * checked through SDFGridFile::hashPolygon(); version 1 files, which
+     * have no hash, are rejected and must be saved again) with the same grid size,
+     * bounds and grid method (and maxDistance for CharacteristicScan);
+     * otherwise nothing changes and false is returned.
+     * On success the grid is published like a generated one, and contours
+     * and rings are extracted from it without touching the polygon.
+     * 
+     * @param path Input file
+     * @param mapFile Map an uncompressed file instead of reading it
+     *                (compressed files are always loaded)
+     * @return true if the grid was loaded and published
+     */
+    bool loadGrid(const std::string& path, bool mapFile = true);
+    
+    /**
+     * @brief Get the grid size and extent the polygon and config produce
+     * 
+     * Available without generating the grid, e.g. to set up the consumers
+     * of streamSDFGrid().
+     * 
+     * @return false if no valid polygon is loaded
+     */
+    bool getGridExtent(int& outWidth, int& outHeight,
+                       float& outMinX, float& outMaxX,
+                       float& outMinY, float& outMaxY) const;
+    
+    /**
+     * @brief Generate the grid in row stripes without keeping it
+     * 
+     * Same samples as the dense grid (DistanceTransform excepted, see
+     * generateSDFGridStripes()); memory stays at one stripe whatever the
+     * grid size. The cached grid is not touched.
+     * 
+     * @param sink Receives every stripe, in row order
+     * @param stripeRows Rows per stripe
+     * @return false without a polygon or if the sink stopped
+     */
+    bool streamSDFGrid(const SDFStripeSink& sink, int stripeRows = 256) const;
+    
+    /**
+     * @brief Generate the grid in stripes straight into a grid file
+     * 
+     * Writes the same file as saveGrid() with SDFGridCompression::None,
+     * without the grid ever being in memory; open it with loadGrid().
+     * 
+     * @param path Output file
+     * @param stripeRows Rows per stripe
+     * @return false without a polygon or on I/O errors
+     */
+    bool streamSDFGridToFile(const std::string& path, int stripeRows = 256) const;
+    
+    /**
+     * @brief Get the world-space extent of the cached grid
+     */
+    void getSDFGridBounds(float& outMinX, float& outMaxX,
+                          float& outMinY, float& outMaxY) const;
+    
     /**
      * @brief Calculate SDF value at a specific point
+     * 
+     * Uses the edge index built by setPolygon(), O(log E) per query.
+     * 
      * @param point Query point
      * @return SDF value (negative inside, positive outside, 0 on boundary)
      */
     float querySDFValue(const Point2D& point) const;
     
+    /**
+     * @brief Calculate SDF values for an array of points
+     * 
+     * Same values as calling querySDFValue() per point. Small polygons are
+     * evaluated with a vectorized kernel (one point per SIMD lane), large
+     * ones through the edge index with the points visited in spatial
+     * order. Large batches are split over config.threadCount threads.
+     * 
+     * @param points Query points
+     * @param count Number of points
+     * @param out Output buffer of count floats
+     */
+    void querySDFValues(const Point2D* points, size_t count, float* out) const;
+    
+    /**
+     * @brief Calculate SDF values for points given as separate x/y arrays
+     * 
+     * @param xs X coordinates
+     * @param ys Y coordinates
+     * @param count Number of points
+     * @param out Output buffer of count floats
+     */
+    void querySDFValues(const float* xs, const float* ys, size_t count, float* out) const;
+    
+    /**
+     * @brief Calculate SDF value and its gradient at a specific point
+     * 
+     * Same value as querySDFValue(); the unit gradient (the surface normal
+     * direction) comes from the nearest edge found by the same traversal,
+     * see calculatePreparedSDFGradient().
+     * 
+     * @param point Query point
+     * @param outGradient Output: unit gradient, (0, 0) without a polygon
+     * @return SDF value (negative inside, positive outside, 0 on boundary)
+     */
+    float querySDFGradient(const Point2D& point, Point2D& outGradient) const;
+    
+    /**
+     * @brief Calculate SDF values and gradients for an array of points
+     * 
+     * Same results as calling querySDFGradient() per point; large batches
+     * are split over config.threadCount threads.
+     * 
+     * @param points Query points
+     * @param count Number of points
+     * @param outDistances Output buffer of count floats
+     * @param outGradients Output buffer of count gradients
+     */
+    void querySDFGradients(const Point2D* points, size_t count,
+                           float* outDistances, Point2D* outGradients) const;
+    
+    /**
+     * @brief Generate the SDF grid together with its gradient field
+     * 
+     * Exact distances and unit gradients (see generateSDFGradientGrid()) at
+     * the samples of getGridExtent(), whatever config.gridMethod. The
+     * cached grid is not touched.
+     * 
+     * @param sdfData Output buffer of width*height floats
+     * @param gradientData Output buffer of width*height gradients
+     * @return false if no valid polygon is loaded
+     */
+    bool generateSDFGradientGrid(float* sdfData, Point2D* gradientData) const;
+    
+    /**
+     * @brief Generate the SDF grid and gradient field interleaved
+     * 
+     * Same values as generateSDFGradientGrid(), (distance, gx, gy) per sample.
+     * 
+     * @param data Output buffer of width*height*3 floats
+     * @return false if no valid polygon is loaded
+     */
+    bool generateSDFGradientGridInterleaved(float* data) const;
+    
+    /**
+     * @brief Approximate SDF value read from the cached grid, O(1) per point
+     * 
+     * Interpolates the grid (generated first if needed) instead of
+     * visiting edges. Points the grid cannot answer for (outside the
+     * interpolation area or next to clamped samples, see
+     * SDFGridSnapshot::sample()) take the exact path of querySDFValue().
+     * With h the grid step (gridSize, or larger where maxGridSize limits
+     * the grid, see getGridExtent()), values are within h * sqrt(2) / 2
+     * (Bilinear) or 1.38 * h (CatmullRom) of querySDFValue(), and much
+     * closer where the field is smooth. This assumes exact samples: the
+     * error of a DistanceTransform grid or a quantized format comes on
+     * top (see SDFInterpolation).
+     * 
+     * @param point Query point
+     * @param interpolation Bilinear or CatmullRom
+     * @param outGradient Optional gradient: of the interpolant on the grid,
+     *                    that of querySDFGradient() on the exact path
+     * @return SDF value (negative inside, positive outside)
+     */
+    float sampleSDF(const Point2D& point,
+                    SDFInterpolation interpolation = SDFInterpolation::Bilinear,
+                    Point2D* outGradient = nullptr);
+    
+    /**
+     * @brief Approximate SDF values for an array of points
+     * 
+     * Same values as calling sampleSDF() per point; large batches are
+     * split over config.threadCount threads.
+     * 
+     * @param points Query points
+     * @param count Number of points
+     * @param out Output buffer of count floats
+     * @param interpolation Bilinear or CatmullRom
+     * @param outGradients Optional output buffer of count gradients
+     */
+    void sampleSDF(const Point2D* points, size_t count, float* out,
+                   SDFInterpolation interpolation = SDFInterpolation::Bilinear,
+                   Point2D* outGradients = nullptr);
+    
+    /**
+     * @brief Get the edge index used by querySDFValue()
+     * @return Index (build time and memory via getBuildTimeMs()/getMemoryUsage())
+     */
+    const EdgeBVH& getEdgeIndex() const { return m_edgeIndex; }
+    
     /**
      * @brief Extract an iso-contour at a specific threshold
+     * 
+     * The last config.contourCacheSize successful results are kept by
+     * threshold (least recently used dropped first), so repeating a
+     * threshold costs a lookup. The cache is cleared whenever the grid
+     * changes: setPolygon(), setConfig(), moveVertex().
+     * 
+     * orderedPoints holds the first loop only; shapes with several
+     * components or holes are complete in contours (parent/depth give the
+     * nesting, signedArea the orientation; with Dense storage holes run
+     * clockwise).
+     * 
+     * Dense float grids are traced with traceIsoContours(), whose seed scan
+     * over all cells runs in row bands on config.threadCount threads; sparse
+     * grids use the banded Marching Squares of SparseSDFGrid, quantized
+     * grids the row-by-row StreamingContourTracer (single-threaded).
+     * 
      * @param threshold SDF threshold value (0.0 = boundary)
      * @return ContourResult containing ordered points and line segments
      */
     ContourResult extractContour(float threshold);
     
+    /**
+     * @brief Extract an iso-contour into a caller-owned result
+     * 
+     * Same contour as extractContour(threshold). Only the fields selected
+     * by outputs are written; the vectors in out are assigned in place, so
+     * a result reused across calls does not allocate once its buffers have
+     * grown and the threshold is answered from the contour cache.
+     * 
+     * @param threshold SDF threshold value (0.0 = boundary)
+     * @param out Result to fill (isValid is always set)
+     * @param outputs SDFContourOutput flags
+     * @return out.isValid
+     */
+    bool extractContour(float threshold, ContourResult& out,
+                        unsigned outputs = SDFContourAll);
+    
+    /**
+     * @brief Extract iso-contours at several thresholds
+     * 
+     * With Dense storage the cached grid is swept once for all thresholds
+     * (see traceIsoContours()) instead of once per threshold; each result
+     * is the same as extractContour() at that threshold. Cached thresholds
+     * are not extracted again.
+     * 
+     * @param thresholds SDF threshold values, any order
+     * @return One ContourResult per threshold, in the same order
+     */
+    std::vector<ContourResult> extractContours(const std::vector<float>& thresholds);
+    
     /**
      * @brief Generate a ring region between two thresholds
+     * 
+     * Both contours go through the contour cache: moving one threshold
+     * extracts only that contour.
+     * 
      * @param outerThreshold Outer contour threshold (should be > innerThreshold)
      * @param innerThreshold Inner contour threshold
      * @return RingResult containing triangle vertices for rendering
      */
     RingResult generateRing(float outerThreshold, float innerThreshold);
     
+    /**
+     * @brief Generate a ring region into a caller-owned result
+     * 
+     * Same ring as generateRing(outerThreshold, innerThreshold). The
+     * contours are copied from the contour cache into out and triangulated
+     * straight into out.triangleVertices, without a triangle list; with
+     * cached thresholds and a reused result the call does not allocate.
+     * out.outerContour and out.innerContour are used as working storage
+     * and are left empty unless SDFRingContours is requested.
+     * 
+     * @param outerThreshold Outer contour threshold (should be > innerThreshold)
+     * @param innerThreshold Inner contour threshold
+     * @param out Result to fill (isValid is always set)
+     * @param outputs SDFRingOutput flags
+     * @return out.isValid
+     */
+    bool generateRing(float outerThreshold, float innerThreshold, RingResult& out,
+                      unsigned outputs = SDFRingAll);
+    
     /**
      * @brief Get the axis-aligned bounding box of the polygon
      * @param outMinX Output minimum X
@@ -127,9 +494,12 @@ public:
     
     /**
      * @brief Update configuration
+     * 
+     * Drops the cached grid and contours; they are rebuilt on demand.
+     * 
      * @param config New configuration
      */
-    void setConfig(const SDFConfig& config) { m_config = config; }
+    void setConfig(const SDFConfig& config);
     
     /**
      * @brief Get current configuration
@@ -137,6 +507,16 @@ public:
      */
     const SDFConfig& getConfig() const { return m_config; }
     
+    /**
+     * @brief Number of contour requests answered from the cache
+     */
+    size_t getContourCacheHits() const { return m_contourCacheHits; }
+    
+    /**
+     * @brief Number of contour requests that had to be extracted
+     */
+    size_t getContourCacheMisses() const { return m_contourCacheMisses; }
+    
     /**
      * @brief Check if a valid polygon is loaded
      * @return true if polygon has >= 3 points
@@ -146,19 +526,50 @@ public:
 private:
     // Internal methods
     void generateSDFGrid();
+    bool generateQuantizedGrid(SDFGridSnapshot& grid) const;
     void clearSDFCache();
+    void computeGridExtent(float& minX, float& maxX, float& minY, float& maxY,
+                           int& width, int& height) const;
+    bool ensureSDFGrid();
+    SDFGridOptions getGridOptions() const;
+    float getClampDistance() const;
+    SDFGridFileInfo getGridFileInfo() const;
+    std::shared_ptr<SDFGridSnapshot> takeRetiredSnapshot();
+    void publishSnapshot(const std::shared_ptr<SDFGridSnapshot>& snapshot);
+    bool computeContours(const std::vector<float>& thresholds,
+                         std::vector<ContourResult>& results);
+    const ContourResult* findCachedContour(float threshold);
+    void cacheContour(float threshold, const ContourResult& result);
+    
+    /**
+     * @brief Contour cache entry
+     */
+    struct CachedContour {
+        float threshold;
+        ContourResult result;
+    };
     
     // Member variables
     std::vector<Point2D> m_polygon;      // Input polygon
+    PreparedPolygon m_prepared;           // Per-edge data, built by setPolygon()
+    EdgeBVH m_edgeIndex;                  // Edge hierarchy for point queries
     SDFConfig m_config;                   // Configuration
     
-    // Cached SDF data (generated on demand)
-    float* m_sdfData;
-    int m_sdfWidth;
-    int m_sdfHeight;
-    float m_sdfMinX, m_sdfMaxX;
-    float m_sdfMinY, m_sdfMaxY;
-    bool m_sdfCacheValid;
+    // Cached SDF grid (generated on demand). m_snapshot is read by other
+    // threads and only ever replaced through std::atomic_store.
+    std::shared_ptr<const SDFGridSnapshot> m_snapshot;
+    std::shared_ptr<const SDFGridSnapshot> m_retired;  // Previous grid, its storage is reused
+    bool m_sdfCacheValid;                 // m_snapshot matches the polygon and config
+    std::string m_mappedPath;             // File m_snapshot is mapped from, if any
+    
+    // Extracted contours, most recently used first
+    std::list<CachedContour> m_contourCache;
+    size_t m_contourCacheHits;
+    size_t m_contourCacheMisses;
+    
+    // Resampling scratch for generateRing()
+    std::vector<Point2D> m_resampledOuter;
+    std::vector<Point2D> m_resampledInner;
 };
 
 #endif // SDF_PROCESSOR_H
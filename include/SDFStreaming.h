@@ -0,0 +1,155 @@
+#ifndef SDF_STREAMING_H
+#define SDF_STREAMING_H
+
+#include "sdf.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/**
+ * @file SDFStreaming.h
+ * @brief Out-of-core SDF grids: generation and contour tracing by row stripes
+ *
+ * generateSDFGridStripes() produces a grid of any size a few hundred rows
+ * at a time and hands every stripe to a sink; StreamingContourTracer
+ * consumes the rows in order and keeps only the previous one. Together
+ * (or with SDFGridFileWriter as the sink) contours of grids far larger
+ * than memory are extracted without the grid ever existing in full.
+ */
+
+/**
+ * @brief Receives the rows of a grid, in order
+ *
+ * @param rowBegin Index of the first row of the stripe
+ * @param rowCount Number of rows in the stripe
+ * @param rows Row-major samples, rowCount * width floats; only valid
+ *             during the call
+ * @return false to stop generation
+ */
+typedef std::function<bool(int rowBegin, int rowCount, const float* rows)> SDFStripeSink;
+
+/**
+ * @brief Generate an SDF grid stripe by stripe
+ *
+ * Samples are the same, bit for bit, as generateSDFGrid() with the same
+ * options, except that DistanceTransform (whose passes need the whole
+ * grid) is generated with Exact. Each stripe is filled in parallel on the
+ * shared thread pool, then passed to the sink on the calling thread.
+ * Memory is one stripe plus per-row edge buckets (O(height + edge
+ * crossings)); prefer CharacteristicScan for very large grids, whose cost
+ * grows with the band area rather than with width * height * edges.
+ *
+ * @param width Width of the grid
+ * @param height Height of the grid
+ * @param worldMinX Minimum X coordinate in world space
+ * @param worldMaxX Maximum X coordinate in world space
+ * @param worldMinY Minimum Y coordinate in world space
+ * @param worldMaxY Maximum Y coordinate in world space
+ * @param prepared Prepared polygon (see preparePolygon())
+ * @param stripeRows Rows per stripe (the last stripe may be shorter)
+ * @param sink Receives every stripe, in row order
+ * @param options Generation options
+ * @return false if the sink stopped generation or the arguments are invalid
+ */
+bool generateSDFGridStripes(int width, int height,
+                            float worldMinX, float worldMaxX,
+                            float worldMinY, float worldMaxY,
+                            const PreparedPolygon& prepared,
+                            int stripeRows,
+                            const SDFStripeSink& sink,
+                            const SDFGridOptions& options = SDFGridOptions());
+
+/**
+ * @brief Traces iso-contours from grid rows fed in order
+ *
+ * Cells are processed as their top row arrives; only the previous row and
+ * the contours still open are kept. Contour pieces are joined through the
+ * grid edges they end on, so the result is the same as traceIsoContours()
+ * on the whole grid: same points, same starting points and orientation,
+ * same order and nesting.
+ *
+ * Usage example:
+ * @code
+ *   StreamingContourTracer tracer(width, height, minX, maxX, minY, maxY, 0.0f);
+ *   generateSDFGridStripes(width, height, minX, maxX, minY, maxY, prepared, 256,
+ *       [&](int, int rowCount, const float* rows) {
+ *           tracer.addRows(rows, rowCount);
+ *           return true;
+ *       });
+ *   std::vector<IsoContour> contours = tracer.finish();
+ * @endcode
+ */
+class StreamingContourTracer {
+public:
+    /**
+     * @brief Constructor (same grid layout as traceIsoContours())
+     * @param isoValue The SDF threshold value to extract
+     */
+    StreamingContourTracer(int width, int height,
+                           float worldMinX, float worldMaxX,
+                           float worldMinY, float worldMaxY,
+                           float isoValue);
+
+    /**
+     * @brief Feed the next rows of the grid
+     * @param rows Row-major samples, rowCount * width floats
+     * @param rowCount Number of rows (rows beyond the grid height are ignored)
+     */
+    void addRows(const float* rows, int rowCount);
+
+    /**
+     * @brief Get the contours, with orientation and nesting
+     *
+     * Call once all rows have been added; contours still open at that
+     * point (too few rows were added) are returned open.
+     */
+    std::vector<IsoContour> finish();
+
+    /**
+     * @brief Number of rows added so far
+     */
+    int getRowCount() const { return m_rowCount; }
+
+private:
+    /**
+     * @brief A contour under construction
+     *
+     * Points run from the crossing on edge headKey to the crossing on edge
+     * tailKey. The seed (cell and entry edge of its first segment in
+     * row-major order) decides where traceIsoContours() would start it.
+     */
+    struct Chain {
+        std::deque<Point2D> points;
+        int64_t headKey, tailKey;
+        int64_t seedCell;
+        int seedEntry;
+        size_t seedPos;  // Index of the seed's entry point in points
+    };
+
+    void addCellRow(const float* bottom, const float* top);
+    void addSegment(int64_t cell, int entry, int64_t entryKey, int64_t exitKey,
+                    const Point2D& entryPoint, const Point2D& exitPoint);
+    int* endSlot(int64_t key, bool head);
+    void emitChain(int chain, bool closed);
+
+    int m_width, m_height;
+    float m_minX, m_minY;
+    float m_cellWidth, m_cellHeight;
+    float m_isoValue;
+    int m_rowCount;
+    std::vector<float> m_previousRow;
+
+    // Open chain ends per grid edge (chain index, -1 for none): horizontal
+    // edges of the two sample rows around the current cell row, vertical
+    // edges of the current cell row
+    std::vector<int> m_horizontalHeads[2], m_horizontalTails[2];
+    std::vector<int> m_verticalHeads, m_verticalTails;
+
+    std::vector<Chain> m_chains;
+    std::vector<int> m_freeChains;
+    std::vector<IsoContour> m_contours;
+    std::vector<int64_t> m_contourSeeds;  // Seed of each contour: cell * 4 + entry
+};
+
+#endif // SDF_STREAMING_H
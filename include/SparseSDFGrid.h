@@ -0,0 +1,126 @@
+#ifndef SPARSE_SDF_GRID_H
+#define SPARSE_SDF_GRID_H
+
+#include "sdf.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file SparseSDFGrid.h
+ * @brief Narrow-band SDF grid stored as sparse bricks
+ *
+ * The grid is split into square bricks of brickSize x brickSize samples.
+ * Only bricks within bandWidth of the polygon boundary store their samples;
+ * every other brick stores a single sign and reads as +/-bandWidth.
+ * Memory therefore grows with the boundary length instead of the grid area,
+ * which allows very large grids (e.g. 8192 x 8192) for thin outlines.
+ *
+ * Samples use the same layout as generateSDFGrid(): sample (x, y) lies at
+ * (worldMinX + (x + 0.5) * stepX, worldMinY + (y + 0.5) * stepY) with
+ * stepX = (worldMaxX - worldMinX) / width.
+ *
+ * Values within bandWidth of the boundary are identical to the dense grid
+ * generated by SDFGridMethod::Exact; all others are clamped to +/-bandWidth.
+ * Iso-contours are exact for |isoValue| <= bandWidth - one cell diagonal.
+ */
+class SparseSDFGrid {
+public:
+    SparseSDFGrid();
+
+    /**
+     * @brief Generate the grid for a polygon
+     *
+     * @param width Number of samples along X
+     * @param height Number of samples along Y
+     * @param worldMinX Minimum X coordinate in world space
+     * @param worldMaxX Maximum X coordinate in world space
+     * @param worldMinY Minimum Y coordinate in world space
+     * @param worldMaxY Maximum Y coordinate in world space
+     * @param prepared Prepared polygon (see preparePolygon())
+     * @param bandWidth Half-width of the stored band in world units
+     *                  (raised to at least two cells)
+     * @param brickSize Brick edge length in samples (default: 8)
+     * @param threadCount Worker threads (0 = all hardware threads, 1 = serial)
+     * @return true on success
+     */
+    bool generate(int width, int height,
+                  float worldMinX, float worldMaxX,
+                  float worldMinY, float worldMaxY,
+                  const PreparedPolygon& prepared,
+                  float bandWidth,
+                  int brickSize = 8,
+                  int threadCount = 0);
+
+    /**
+     * @brief Release all bricks
+     */
+    void clear();
+
+    /**
+     * @brief Check if the grid holds data
+     */
+    bool isValid() const { return m_width > 0; }
+
+    /**
+     * @brief SDF value of grid sample (x, y)
+     */
+    float getValue(int x, int y) const;
+
+    /**
+     * @brief Bilinearly interpolated SDF value at a world position
+     *
+     * Positions outside the sample area are clamped to the border samples.
+     */
+    float sample(const Point2D& point) const;
+
+    /**
+     * @brief Marching Squares on the bricks
+     *
+     * Only cells touching a stored brick are visited. Brick rows are
+     * processed in parallel and concatenated in order, so the output does
+     * not depend on the thread count.
+     *
+     * @param isoValue The SDF threshold value to extract
+     * @param threadCount Worker threads (1 = calling thread only, 0 = all cores)
+     * @return Line segments (pairs of points), with the cell layout of
+     *         extractIsoContour() on the dense grid
+     */
+    std::vector<Point2D> extractIsoContour(float isoValue, int threadCount = 1) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getBrickSize() const { return m_brickSize; }
+    float getBandWidth() const { return m_bandWidth; }
+
+    /**
+     * @brief Number of bricks that store samples
+     */
+    int getActiveBrickCount() const;
+
+    /**
+     * @brief Total number of bricks covering the grid
+     */
+    int getBrickCount() const { return m_bricksX * m_bricksY; }
+
+    /**
+     * @brief Bytes used by the brick table and the stored samples
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    // Brick table entries below zero are "far" bricks
+    enum { FAR_OUTSIDE = -1, FAR_INSIDE = -2 };
+
+    int m_width, m_height;
+    int m_brickSize;
+    int m_bricksX, m_bricksY;
+    float m_worldMinX, m_worldMaxX;
+    float m_worldMinY, m_worldMaxY;
+    float m_stepX, m_stepY;
+    float m_bandWidth;
+
+    std::vector<int> m_brickTable;   // Per brick: index into m_brickData, or FAR_*
+    std::vector<float> m_brickData;  // brickSize^2 samples per stored brick, row-major
+};
+
+#endif // SPARSE_SDF_GRID_H
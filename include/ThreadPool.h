@@ -0,0 +1,81 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @file ThreadPool.h
+ * @brief Small reusable worker pool used by the parallel SDF routines
+ *
+ * Workers are created once and reused for every parallel call, so grid
+ * generation does not pay thread start-up cost per polygon.
+ */
+
+/**
+ * @brief Fixed-size pool of worker threads
+ *
+ * The calling thread always takes part in parallelFor(), so nested calls
+ * (a parallel task that itself calls parallelFor) cannot deadlock even when
+ * every worker is busy.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor
+     * @param workerCount Number of worker threads (0 = hardware concurrency - 1)
+     */
+    explicit ThreadPool(int workerCount = 0);
+
+    /**
+     * @brief Destructor, waits for queued work and joins all workers
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Run task(i) for every i in [0, taskCount)
+     *
+     * Tasks are claimed dynamically, so uneven task costs still balance.
+     * Returns once every task has finished.
+     *
+     * @param taskCount Number of tasks
+     * @param maxThreads Maximum number of threads working on the call,
+     *                   including the caller (0 = no limit)
+     * @param task Task body, called with the task index
+     */
+    void parallelFor(int taskCount, int maxThreads,
+                     const std::function<void(int)>& task);
+
+    /**
+     * @brief Get the number of worker threads (excluding callers)
+     */
+    int getWorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+    /**
+     * @brief Get the process-wide shared pool (created on first use)
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief Resolve a user thread count setting (0 = all hardware threads)
+     */
+    static int resolveThreadCount(int threadCount);
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()> > m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
+
+#endif // THREAD_POOL_H
@@ -56,6 +56,63 @@ bool isPointInPolygon(const Point2D& p, const std::vector<Point2D>& polygon);
  */
 float calculatePolygonSDF(const Point2D& p, const std::vector<Point2D>& polygon);
 
+/**
+ * @brief Polygon edges preprocessed for repeated SDF evaluation
+ * 
+ * Structure-of-arrays layout, one entry per edge (closing edge included).
+ * Build it once with preparePolygon() and reuse it for every query.
+ */
+struct PreparedPolygon {
+    std::vector<float> originX, originY;  // Edge start point a
+    std::vector<float> dirX, dirY;        // Edge direction (b - a)
+    std::vector<float> invLengthSq;       // 1 / |b - a|^2 (0 for degenerate edges)
+    std::vector<float> minY, maxY;        // Edge y-range, used by the winding test
+    int edgeCount;                        // Number of edges (0 if polygon is invalid)
+    
+    PreparedPolygon() : edgeCount(0) {}
+};
+
+/**
+ * @brief Precompute per-edge data of a polygon
+ * 
+ * @param polygon Vector of points defining the polygon
+ * @param prepared Output prepared polygon (storage is reused)
+ */
+void preparePolygon(const std::vector<Point2D>& polygon, PreparedPolygon& prepared);
+
+/**
+ * @brief Calculate the signed distance field value against a prepared polygon
+ * 
+ * Distance and winding number are accumulated in a single pass over the
+ * edges. Returns the same value as calculatePolygonSDF() for the polygon
+ * the data was prepared from.
+ * 
+ * @param p The query point
+ * @param prepared Prepared polygon
+ * @return float The signed distance value
+ */
+float calculatePreparedSDF(const Point2D& p, const PreparedPolygon& prepared);
+
+/**
+ * @brief Signed distance and its gradient against a prepared polygon
+ * 
+ * The gradient comes from the same pass over the edges as the distance:
+ * it is the unit vector from the nearest point on the nearest edge to p,
+ * negated inside, so the surface normal costs one division instead of the
+ * four extra evaluations of central differences. On the boundary it is the
+ * outward normal of the nearest edge. It is undefined on the medial axis,
+ * where the first nearest edge (in edge order) is used.
+ * 
+ * The distance is the same as calculatePreparedSDF().
+ * 
+ * @param p The query point
+ * @param prepared Prepared polygon
+ * @param outGradient Output: unit gradient, (0, 0) if the polygon is invalid
+ * @return float The signed distance value
+ */
+float calculatePreparedSDFGradient(const Point2D& p, const PreparedPolygon& prepared,
+                                   Point2D& outGradient);
+
 /**
  * @brief Generate a 2D SDF texture/grid for a polygon
  * 
@@ -76,6 +133,184 @@ void generateSDFGrid(int width, int height,
                      const std::vector<Point2D>& polygon,
                      float* sdfData);
 
+/**
+ * @brief Algorithm used to fill an SDF grid
+ * 
+ * - Exact: every sample is evaluated against every edge, O(W * H * E).
+ * - DistanceTransform: the boundary is seeded at sub-pixel precision in a
+ *   one-cell band, then a separable exact Euclidean distance transform
+ *   (Felzenszwalb-Huttenlocher) propagates the nearest seed to every sample,
+ *   O(W * H + E). Seeded samples are exact; every other sample measures its
+ *   exact distance to the edge found through its seed, so it never
+ *   underestimates. Measured error relative to Exact: when edges span
+ *   several cells, mean below 1e-4 cells with rare outliers up to ~0.4
+ *   cells; for finely tessellated outlines (edges shorter than a cell), mean
+ *   ~0.02 cells and max ~1 cell. Signs are identical to Exact.
+ *   Requires the grid to contain the polygon, otherwise Exact is used.
+ * - CharacteristicScan: only samples within maxDistance of the boundary are
+ *   computed. Each edge's slab and each vertex's wedge (its characteristic
+ *   regions) is scan-converted and its samples get the exact distance to
+ *   that feature, O(E + band area + W * H). Identical to Exact within
+ *   maxDistance; every other sample is clamped to +/-maxDistance. Signs are
+ *   identical to Exact.
+ *   Takes its band from SDFGridOptions::maxDistance (default 0.5, as in
+ *   SDFConfig), which should match the scale of the world bounds. Falls
+ *   back to Exact when maxDistance <= 0.
+ */
+enum class SDFGridMethod {
+    Exact,
+    DistanceTransform,
+    CharacteristicScan
+};
+
+/**
+ * @brief Options for SDF grid generation
+ */
+struct SDFGridOptions {
+    int threadCount;       // Worker threads (0 = all hardware threads, 1 = serial)
+    bool useSIMD;          // Use the vectorized row kernel (scalar path otherwise)
+    SDFGridMethod method;  // Grid algorithm (default: Exact)
+    float maxDistance;     // Band half-width for CharacteristicScan, world units (default: 0.5)
+    bool useScanlineSign;  // Exact: signs from computeInsideMask() instead of per-sample winding
+    
+    SDFGridOptions()
+        : threadCount(0), useSIMD(true), method(SDFGridMethod::Exact),
+          maxDistance(0.5f), useScanlineSign(true) {}
+};
+
+/**
+ * @brief Generate a 2D SDF grid with explicit generation options
+ * 
+ * Rows are split into bands and spread over the shared thread pool.
+ * Every cell is computed exactly as in the serial path, so the output is
+ * bit-identical for any thread count.
+ * 
+ * With useSIMD, each row is evaluated by a vectorized kernel (SSE2, AVX2 or
+ * AVX-512, chosen at runtime) that processes a block of pixels against one
+ * edge at a time. It performs the same float operations per pixel as
+ * calculatePreparedSDF(), so the result also matches the scalar path.
+ * 
+ * With useScanlineSign, the signs of the whole grid come from one
+ * computeInsideMask() pass and the row kernels only compute distances.
+ * Output is identical either way.
+ * 
+ * @param width Width of the output grid
+ * @param height Height of the output grid
+ * @param worldMinX Minimum X coordinate in world space
+ * @param worldMaxX Maximum X coordinate in world space
+ * @param worldMinY Minimum Y coordinate in world space
+ * @param worldMaxY Maximum Y coordinate in world space
+ * @param polygon Vector of points defining the polygon
+ * @param sdfData Output buffer (must be pre-allocated with width*height floats)
+ * @param options Generation options (thread count, ...)
+ */
+void generateSDFGrid(int width, int height,
+                     float worldMinX, float worldMaxX,
+                     float worldMinY, float worldMaxY,
+                     const std::vector<Point2D>& polygon,
+                     float* sdfData,
+                     const SDFGridOptions& options);
+
+/**
+ * @brief Generate a 2D SDF grid from a prepared polygon
+ * 
+ * Same as the std::vector overload, without re-preparing the edges.
+ */
+void generateSDFGrid(int width, int height,
+                     float worldMinX, float worldMaxX,
+                     float worldMinY, float worldMaxY,
+                     const PreparedPolygon& prepared,
+                     float* sdfData,
+                     const SDFGridOptions& options);
+
+/**
+ * @brief Generate an SDF grid together with its gradient field
+ * 
+ * Every sample is computed as by calculatePreparedSDFGradient(), in the
+ * layout of generateSDFGrid(); distances are the same as generateSDFGrid()
+ * with the Exact method. Rows are spread over the shared thread pool and,
+ * with useSIMD, evaluated by vectorized kernels that track the nearest
+ * edge offset per lane. options.method and options.useScanlineSign are
+ * ignored.
+ * 
+ * @param width Width of the output grid
+ * @param height Height of the output grid
+ * @param worldMinX Minimum X coordinate in world space
+ * @param worldMaxX Maximum X coordinate in world space
+ * @param worldMinY Minimum Y coordinate in world space
+ * @param worldMaxY Maximum Y coordinate in world space
+ * @param prepared Prepared polygon (see preparePolygon())
+ * @param sdfData Output buffer of width*height floats
+ * @param gradientData Output buffer of width*height unit gradients
+ * @param options Generation options (thread count, SIMD)
+ */
+void generateSDFGradientGrid(int width, int height,
+                             float worldMinX, float worldMaxX,
+                             float worldMinY, float worldMaxY,
+                             const PreparedPolygon& prepared,
+                             float* sdfData, Point2D* gradientData,
+                             const SDFGridOptions& options = SDFGridOptions());
+
+/**
+ * @brief Generate an SDF grid and its gradient field in one interleaved buffer
+ * 
+ * Same values as generateSDFGradientGrid(), stored as (distance, gx, gy)
+ * per sample, e.g. for upload as an RGB32F texture.
+ * 
+ * @param data Output buffer of width*height*3 floats
+ */
+void generateSDFGradientGridInterleaved(int width, int height,
+                                        float worldMinX, float worldMaxX,
+                                        float worldMinY, float worldMaxY,
+                                        const PreparedPolygon& prepared,
+                                        float* data,
+                                        const SDFGridOptions& options = SDFGridOptions());
+
+/**
+ * @brief Classify every grid sample as inside/outside with one scanline pass
+ * 
+ * Edge crossings are bucketed per grid row once; each row is then filled
+ * from its crossings with the nonzero winding rule, O(E + crossings + W*H)
+ * instead of a point-in-polygon test per sample. The per-sample decision
+ * uses the same predicate as calculatePreparedSDF(), so the mask matches
+ * its sign exactly. Samples use the layout of generateSDFGrid().
+ * 
+ * @param width Width of the grid
+ * @param height Height of the grid
+ * @param worldMinX Minimum X coordinate in world space
+ * @param worldMaxX Maximum X coordinate in world space
+ * @param worldMinY Minimum Y coordinate in world space
+ * @param worldMaxY Maximum Y coordinate in world space
+ * @param prepared Prepared polygon (see preparePolygon())
+ * @param insideMask Output buffer of width*height bytes (1 = inside, 0 = outside)
+ * @param threadCount Worker threads (0 = all hardware threads, 1 = serial)
+ */
+void computeInsideMask(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const PreparedPolygon& prepared,
+                       unsigned char* insideMask,
+                       int threadCount = 0);
+
+/**
+ * @brief Scanline inside/outside classification for a polygon
+ * 
+ * Same as the PreparedPolygon overload.
+ */
+void computeInsideMask(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const std::vector<Point2D>& polygon,
+                       unsigned char* insideMask,
+                       int threadCount = 0);
+
+/**
+ * @brief Get the name of the vectorized grid kernel selected for this CPU
+ * 
+ * @return "AVX-512", "AVX2", "SSE2" or "Scalar"
+ */
+const char* getSIMDKernelName();
+
 /**
  * @brief Calculate axis-aligned bounding box for a polygon
  * 
@@ -95,6 +330,12 @@ void calculatePolygonBounds(const std::vector<Point2D>& polygon,
  * This function extracts a contour line where the SDF value equals the threshold.
  * The contour is represented as a series of line segments connecting points.
  * 
+ * With threadCount != 1 the cell rows are split into bands that are
+ * processed in parallel, each into its own buffer; the buffers are then
+ * concatenated in row order. Every cell belongs to exactly one band, so
+ * seams produce no duplicate segments, and the output is identical to the
+ * single-threaded result for any thread count.
+ * 
  * @param sdfData The SDF grid data (row-major order)
  * @param width Width of the SDF grid
  * @param height Height of the SDF grid
@@ -103,13 +344,134 @@ void calculatePolygonBounds(const std::vector<Point2D>& polygon,
  * @param worldMinY Minimum Y coordinate in world space
  * @param worldMaxY Maximum Y coordinate in world space
  * @param isoValue The SDF threshold value to extract (typically 0.0 for boundary)
+ * @param threadCount Worker threads (1 = calling thread only, 0 = all cores)
  * @return Vector of points forming the contour line segments (pairs of points)
  */
 std::vector<Point2D> extractIsoContour(const float* sdfData,
                                        int width, int height,
                                        float worldMinX, float worldMaxX,
                                        float worldMinY, float worldMaxY,
-                                       float isoValue);
+                                       float isoValue,
+                                       int threadCount = 1);
+
+/**
+ * @brief Extract several iso-contours in one sweep over the grid
+ * 
+ * Each 2x2 cell is loaded once; the levels crossing it are found by binary
+ * search in isoValues on the cell's value range, so the grid is read once
+ * instead of once per level. The segments of each level are the same, in
+ * the same order, as extractIsoContour() at that level.
+ * 
+ * @param isoValues Levels in ascending order (empty result otherwise)
+ * @param threadCount Worker threads (1 = calling thread only, 0 = all cores)
+ * @return One segment list (pairs of points) per level, in isoValues order
+ */
+std::vector<std::vector<Point2D> > extractIsoContours(const float* sdfData,
+                                                      int width, int height,
+                                                      float worldMinX, float worldMaxX,
+                                                      float worldMinY, float worldMaxY,
+                                                      const std::vector<float>& isoValues,
+                                                      int threadCount = 1);
+
+/**
+ * @brief Ordered iso-contour polyline
+ */
+struct IsoContour {
+    std::vector<Point2D> points;  // Vertices in walking order (first point not repeated)
+    bool closed;                  // false if the contour runs into the grid border
+    float signedArea;             // Shoelace area, > 0 for counter-clockwise loops
+    int parent;                   // Nearest enclosing closed contour, -1 for none (and open contours)
+    int depth;                    // Number of enclosing closed contours
+};
+
+/**
+ * @brief Extract iso-contours as ordered polylines by contour tracing
+ * 
+ * Same cells and crossing points as extractIsoContour(), but each contour
+ * is followed cell to cell from a seed crossing cell instead of emitting
+ * unordered segments. Consecutive segments share their vertex exactly, so
+ * no epsilon matching (connectLineSegments()) is needed, and every loop is
+ * found. Only crossing cells are evaluated; the rest of the grid is just
+ * compared against isoValue while scanning for seeds.
+ * 
+ * Contours are oriented with the side above isoValue on the right, i.e.
+ * loops around regions below isoValue (the inside of a polygon for
+ * isoValue 0) run counter-clockwise. Open contours start and end on the
+ * grid border. Orientation and nesting are filled in as by
+ * buildContourHierarchy().
+ * 
+ * With threadCount != 1 the seed scan, which visits every cell, runs in
+ * row bands in parallel; tracing, which only visits crossing cells, stays
+ * on the calling thread and starts from the seeds in row-major order, so
+ * the result is the same for any thread count.
+ * 
+ * @param sdfData The SDF grid data (row-major order)
+ * @param width Width of the SDF grid
+ * @param height Height of the SDF grid
+ * @param worldMinX Minimum X coordinate in world space
+ * @param worldMaxX Maximum X coordinate in world space
+ * @param worldMinY Minimum Y coordinate in world space
+ * @param worldMaxY Maximum Y coordinate in world space
+ * @param isoValue The SDF threshold value to extract
+ * @param threadCount Threads for the seed scan (1 = calling thread only, 0 = all cores)
+ * @return Contours in the row-major order of their first cell
+ */
+std::vector<IsoContour> traceIsoContours(const float* sdfData,
+                                         int width, int height,
+                                         float worldMinX, float worldMaxX,
+                                         float worldMinY, float worldMaxY,
+                                         float isoValue,
+                                         int threadCount = 1);
+
+/**
+ * @brief Trace several iso-contours after one sweep over the grid
+ * 
+ * One pass loads each cell once and records it as a seed for every level
+ * crossing its value range (binary search in isoValues); each level is
+ * then traced from its seeds only. Per level, the result is the same as
+ * traceIsoContours() at that level. The sweep is split into row bands
+ * with threadCount != 1, as the seed scan of traceIsoContours().
+ * 
+ * @param isoValues Levels in ascending order (empty result otherwise)
+ * @param threadCount Threads for the sweep (1 = calling thread only, 0 = all cores)
+ * @return One contour set per level, in isoValues order
+ */
+std::vector<std::vector<IsoContour> > traceIsoContours(const float* sdfData,
+                                                       int width, int height,
+                                                       float worldMinX, float worldMaxX,
+                                                       float worldMinY, float worldMaxY,
+                                                       const std::vector<float>& isoValues,
+                                                       int threadCount = 1);
+
+/**
+ * @brief Fill in orientation and nesting of a set of contours
+ * 
+ * Computes signedArea for every contour, and for closed contours the
+ * containment tree (parent, depth) by a single sweep over their edges,
+ * O(n log n) in the total number of vertices. Contours must not cross
+ * each other, which holds for iso-contours of one field. Open contours
+ * get parent -1 and depth 0 and do not enclose anything.
+ * 
+ * @param contours Contours to update
+ */
+void buildContourHierarchy(std::vector<IsoContour>& contours);
+
+/**
+ * @brief Connect line segments into every polyline they form
+ * 
+ * Endpoints are matched through a hash grid of cell size epsilon, so the
+ * cost is linear in the number of segments. Each segment is used once;
+ * segments may come in either direction and are walked in whichever
+ * direction continues the polyline. Polylines that do not return to
+ * their start are returned open, from one free end to the other.
+ * Orientation and nesting are filled in by buildContourHierarchy().
+ * 
+ * @param segments Line segments (pairs of points: P0,P1, P2,P3, ...)
+ * @param epsilon Endpoints closer than this are joined
+ * @return Polylines in the order of their first segment
+ */
+std::vector<IsoContour> connectAllLineSegments(const std::vector<Point2D>& segments,
+                                               float epsilon = 0.001f);
 
 /**
  * @brief Connect line segments into an ordered closed contour
@@ -117,6 +479,9 @@ std::vector<Point2D> extractIsoContour(const float* sdfData,
  * Marching Squares produces unordered line segments. This function connects them
  * into a continuous closed contour.
  * 
+ * Only the polyline through the first segment is returned; use
+ * connectAllLineSegments() for shapes with several components or holes.
+ * 
  * @param segments Line segments (pairs of points: P0,P1, P2,P3, ...)
  * @return Ordered contour points forming a closed loop
  */
@@ -134,6 +499,19 @@ std::vector<Point2D> connectLineSegments(const std::vector<Point2D>& segments);
  */
 std::vector<Point2D> resampleContour(const std::vector<Point2D>& contour, int targetCount);
 
+/**
+ * @brief Resample a contour into a caller-owned buffer
+ * 
+ * Same points as resampleContour(); out is cleared first and keeps its
+ * capacity, so a reused buffer is not reallocated.
+ * 
+ * @param contour Original contour points
+ * @param targetCount Target number of points
+ * @param out Output resampled points
+ */
+void resampleContour(const std::vector<Point2D>& contour, int targetCount,
+                     std::vector<Point2D>& out);
+
 /**
  * @brief Triangulate the ring region between two contours using Triangle Strip method
  * 
@@ -157,6 +535,27 @@ std::vector<Triangle> triangulateRing(
  */
 std::vector<Point2D> trianglesToVertices(const std::vector<Triangle>& triangles);
 
+/**
+ * @brief Triangulate a ring straight into a flat vertex array
+ * 
+ * Same vertices as trianglesToVertices(triangulateRing(...)), without the
+ * intermediate triangle list. All buffers are caller-owned and keep their
+ * capacity, so repeated calls with reused buffers do not allocate once
+ * they have grown.
+ * 
+ * @param outerContour Outer contour points (should be closed)
+ * @param innerContour Inner contour points (should be closed)
+ * @param outVertices Output vertices (3 per triangle)
+ * @param resampledOuter Scratch: outer contour after resampling
+ * @param resampledInner Scratch: inner contour after resampling
+ * @return Number of triangles, 0 on failure
+ */
+int triangulateRing(const std::vector<Point2D>& outerContour,
+                    const std::vector<Point2D>& innerContour,
+                    std::vector<Point2D>& outVertices,
+                    std::vector<Point2D>& resampledOuter,
+                    std::vector<Point2D>& resampledInner);
+
 /**
  * @brief Linear interpolation helper function
  */
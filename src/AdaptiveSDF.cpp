@@ -0,0 +1,665 @@
+#include "AdaptiveSDF.h"
+#include "EdgeBVH.h"
+#include "ThreadPool.h"
+#include "sdf_backends.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+static const int ADF_EVAL_BLOCK = 256;   // Exact evaluations per task
+static const int ADF_CELL_BLOCK = 64;    // Error bounds per task
+
+/**
+ * @brief Build state: values are keyed by their position on the lattice of
+ *        the finest level, so neighbouring cells share them
+ */
+struct ADFBuilder {
+    EdgeBVH index;
+    float worldMinX, worldMinY;
+    float stepX, stepY;           // Lattice spacing (finest level)
+    std::unordered_map<uint64_t, int> vertexIds;
+    std::vector<float> values;
+    std::vector<Point2D> pending; // Requested, not evaluated yet
+    size_t pendingStart;          // values[pendingStart..] belong to pending
+
+    static uint64_t key(uint32_t ix, uint32_t iy)
+    {
+        return (static_cast<uint64_t>(ix) << 32) | iy;
+    }
+
+    /**
+     * @brief Id of the lattice vertex (ix, iy), queued for evaluation if new
+     */
+    int request(uint32_t ix, uint32_t iy)
+    {
+        std::pair<std::unordered_map<uint64_t, int>::iterator, bool> inserted =
+            vertexIds.insert(std::make_pair(key(ix, iy), static_cast<int>(values.size())));
+        if (inserted.second)
+        {
+            values.push_back(0.0f);
+            Point2D p = {worldMinX + ix * stepX, worldMinY + iy * stepY};
+            pending.push_back(p);
+        }
+        return inserted.first->second;
+    }
+
+    /**
+     * @brief Evaluate all queued vertices
+     */
+    void evaluate(int threads)
+    {
+        const int count = static_cast<int>(pending.size());
+        const int taskCount = (count + ADF_EVAL_BLOCK - 1) / ADF_EVAL_BLOCK;
+        float* out = values.data() + pendingStart;
+
+        ThreadPool::shared().parallelFor(taskCount, threads, [&](int task)
+        {
+            int end = std::min(count, (task + 1) * ADF_EVAL_BLOCK);
+            for (int k = task * ADF_EVAL_BLOCK; k < end; k++)
+                out[k] = index.signedDistance(pending[k]);
+        });
+
+        pending.clear();
+        pendingStart = values.size();
+    }
+
+    /**
+     * @brief Id of an evaluated vertex, or -1
+     */
+    int findVertex(uint32_t ix, uint32_t iy) const
+    {
+        std::unordered_map<uint64_t, int>::const_iterator it = vertexIds.find(key(ix, iy));
+        return (it != vertexIds.end()) ? it->second : -1;
+    }
+};
+
+/**
+ * @brief Cell position on the lattice
+ */
+struct ADFCell {
+    int node;
+    uint32_t ix, iy, size;
+    uint32_t probes;     // Probe squares per side the cell was tested with
+    size_t probeStart;   // Its (probes + 1)^2 probe ids in the build's probe list
+    int corners[4];      // Vertex ids: bottom-left, bottom-right, top-right, top-left
+    bool verified;       // Checked against its current corner values
+};
+
+static inline float bilinear(float v0, float v1, float v2, float v3, float u, float v)
+{
+    // v0..v3: bottom-left, bottom-right, top-right, top-left
+    return lerp(lerp(v0, v1, u), lerp(v3, v2, u), v);
+}
+
+/**
+ * @brief Whether |SDF - reconstruction| stays within errorBound over a whole cell
+ *
+ * The cell is cut into probes x probes squares whose corners are exact
+ * samples; the reconstruction is the bilinear interpolation of corners
+ * (bottom-left, bottom-right, top-right, top-left).
+ *
+ * On a square the boundary cannot cross, |SDF| is the minimum of the
+ * distance functions of the edges that can be nearest in the cell. Each of
+ * them is convex, so it lies below the bilinear interpolation of its values
+ * at the square's corners and above its tangent plane at the square's
+ * center. The reconstruction is bilinear on the square too, so both bounds
+ * only need checking at the corners. Squares the boundary may cross use the
+ * Lipschitz bound instead: the error at the corners plus
+ * (1 + max |gradient of the reconstruction|) times the half-diagonal, which
+ * is also tried first on every square as it is cheap.
+ *
+ * @param ids Row-major ids of the (probes + 1)^2 probes
+ * @param nearby Scratch buffer for the nearby edges
+ */
+static bool cellWithinBound(const ADFBuilder& builder, const PreparedPolygon& prepared,
+                            const ADFCell& cell, uint32_t probes, const int* ids,
+                            const float corners[4], float errorBound, std::vector<int>& nearby)
+{
+    const uint32_t row = probes + 1;
+    const uint32_t spacing = cell.size / probes;
+    const float sizeX = cell.size * builder.stepX;
+    const float sizeY = cell.size * builder.stepY;
+    const float halfDiagonal = 0.5f * std::sqrt(sizeX * sizeX + sizeY * sizeY) / probes;
+
+    float exact[25], approx[25];
+    Point2D points[25];
+    for (uint32_t j = 0; j <= probes; j++)
+    {
+        for (uint32_t i = 0; i <= probes; i++)
+        {
+            uint32_t ix = cell.ix + spacing * i, iy = cell.iy + spacing * j;
+            exact[j * row + i] = builder.values[ids[j * row + i]];
+            approx[j * row + i] = bilinear(corners[0], corners[1], corners[2], corners[3],
+                                           static_cast<float>(i) / probes,
+                                           static_cast<float>(j) / probes);
+            Point2D p = {builder.worldMinX + ix * builder.stepX, builder.worldMinY + iy * builder.stepY};
+            points[j * row + i] = p;
+        }
+    }
+
+    const float gradientX = std::max(std::fabs(corners[1] - corners[0]), std::fabs(corners[2] - corners[3])) / sizeX;
+    const float gradientY = std::max(std::fabs(corners[3] - corners[0]), std::fabs(corners[2] - corners[1])) / sizeY;
+    const float lipschitz = 1.0f + std::sqrt(gradientX * gradientX + gradientY * gradientY);
+
+    bool nearbyFound = false;
+    for (uint32_t j = 0; j < probes; j++)
+    {
+        for (uint32_t i = 0; i < probes; i++)
+        {
+            const uint32_t square[4] = {j * row + i, j * row + i + 1, (j + 1) * row + i + 1, (j + 1) * row + i};
+            float cornerError = 0.0f;
+            float nearest = std::fabs(exact[square[0]]);
+            bool sameSign = true;
+            for (int k = 0; k < 4; k++)
+            {
+                cornerError = std::max(cornerError, std::fabs(exact[square[k]] - approx[square[k]]));
+                nearest = std::min(nearest, std::fabs(exact[square[k]]));
+                sameSign = sameSign && ((exact[square[k]] < 0.0f) == (exact[square[0]] < 0.0f));
+            }
+
+            if (cornerError + lipschitz * halfDiagonal <= errorBound)
+                continue;
+            if (!sameSign || !(nearest > halfDiagonal))
+                return false;
+
+            if (!nearbyFound)
+            {
+                // Every edge nearest to some point of the cell: within the distance of
+                // a reference probe plus twice the farthest point of the cell from it
+                const uint32_t reference = (probes % 2 == 0) ? (probes / 2) * row + probes / 2 : 0;
+                const float reach = (probes % 2 == 0) ? 0.5f : 1.0f;
+                const float radius = std::fabs(exact[reference]) +
+                                     2.0f * reach * std::sqrt(sizeX * sizeX + sizeY * sizeY);
+                builder.index.edgesWithin(points[reference], radius * (1.0f + 1e-4f), nearby);
+                nearbyFound = true;
+            }
+            if (nearby.empty())
+                return false;
+
+            // |SDF| against the reconstruction with the sign of the square
+            const float sign = (exact[square[0]] < 0.0f) ? -1.0f : 1.0f;
+            const Point2D center = {0.5f * (points[square[0]].x + points[square[2]].x),
+                                    0.5f * (points[square[0]].y + points[square[2]].y)};
+            float largest = -std::numeric_limits<float>::max();
+            for (int k = 0; k < 4; k++)
+                largest = std::max(largest, sign * approx[square[k]]);
+
+            float above = std::numeric_limits<float>::max();   // Upper bound of |SDF| - w
+            float below = std::numeric_limits<float>::max();   // Lower bound of |SDF| - w
+            for (size_t n = 0; n < nearby.size(); n++)
+            {
+                const int e = nearby[n];
+                float pax = center.x - prepared.originX[e];
+                float pay = center.y - prepared.originY[e];
+                float t = clamp((pax * prepared.dirX[e] + pay * prepared.dirY[e]) * prepared.invLengthSq[e], 0.0f, 1.0f);
+                float ex = pax - prepared.dirX[e] * t;
+                float ey = pay - prepared.dirY[e] * t;
+                float dist = std::sqrt(ex * ex + ey * ey);
+                if (!(dist > 0.0f))
+                    return false;
+
+                // Both bounds of this edge are at least its distance across the square
+                if (dist - halfDiagonal - largest >= std::max(above, below))
+                    continue;
+
+                float chord = -std::numeric_limits<float>::max();
+                for (int k = 0; k < 4; k++)
+                {
+                    chord = std::max(chord, preparedEdgeDistance(prepared, e, points[square[k]].x, points[square[k]].y) -
+                                            sign * approx[square[k]]);
+                    float tangent = dist + (ex * (points[square[k]].x - center.x) +
+                                            ey * (points[square[k]].y - center.y)) / dist;
+                    below = std::min(below, tangent - sign * approx[square[k]]);
+                }
+                above = std::min(above, chord);
+                if (-below > errorBound)
+                    return false;
+            }
+
+            if (above > errorBound)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Snap every evaluated vertex strictly inside a leaf edge onto the
+ *        linear interpolation of the edge (recursively, midpoint first)
+ *
+ * Writes values, and records in source the first (coarsest) leaf that
+ * snapped each vertex.
+ */
+static void snapEdge(const ADFBuilder& builder, std::vector<float>& values,
+                     std::vector<int>& source, int leaf,
+                     uint32_t ax, uint32_t ay, float va,
+                     uint32_t bx, uint32_t by, float vb,
+                     uint32_t length)
+{
+    if (length < 2)
+        return;
+
+    uint32_t mx = (ax + bx) / 2;
+    uint32_t my = (ay + by) / 2;
+    int id = builder.findVertex(mx, my);
+    if (id < 0)
+        return;  // No finer cell touches this half of the edge
+
+    float vm = 0.5f * (va + vb);
+    values[id] = vm;
+    if (source[id] < 0)
+        source[id] = leaf;
+    snapEdge(builder, values, source, leaf, ax, ay, va, mx, my, vm, length / 2);
+    snapEdge(builder, values, source, leaf, mx, my, vm, bx, by, vb, length / 2);
+}
+
+AdaptiveSDF::AdaptiveSDF()
+    : m_worldMinX(0.0f)
+    , m_worldMaxX(0.0f)
+    , m_worldMinY(0.0f)
+    , m_worldMaxY(0.0f)
+    , m_maxDepth(0)
+{
+}
+
+void AdaptiveSDF::clear()
+{
+    m_nodes.clear();
+    m_values.clear();
+    m_maxDepth = 0;
+}
+
+bool AdaptiveSDF::build(const PreparedPolygon& prepared,
+                        float worldMinX, float worldMaxX,
+                        float worldMinY, float worldMaxY,
+                        float errorBound,
+                        int maxDepth,
+                        int minDepth,
+                        int threadCount)
+{
+    clear();
+
+    if (prepared.edgeCount < 3)
+    {
+        std::cerr << "AdaptiveSDF: Invalid polygon" << std::endl;
+        return false;
+    }
+
+    if (!(worldMaxX > worldMinX) || !(worldMaxY > worldMinY) ||
+        !(errorBound > 0.0f) || maxDepth < 1 || maxDepth > 20)
+    {
+        std::cerr << "AdaptiveSDF: Invalid region, error bound or depth" << std::endl;
+        return false;
+    }
+
+    m_worldMinX = worldMinX;
+    m_worldMaxX = worldMaxX;
+    m_worldMinY = worldMinY;
+    m_worldMaxY = worldMaxY;
+    minDepth = std::max(0, std::min(minDepth, maxDepth));
+
+    const int threads = ThreadPool::resolveThreadCount(threadCount);
+    const uint32_t resolution = 1u << maxDepth;
+
+    ADFBuilder builder;
+    builder.index.build(prepared);
+    builder.worldMinX = worldMinX;
+    builder.worldMinY = worldMinY;
+    builder.stepX = (worldMaxX - worldMinX) / resolution;
+    builder.stepY = (worldMaxY - worldMinY) / resolution;
+    builder.pendingStart = 0;
+
+    const float latticeDiagonal = std::sqrt(builder.stepX * builder.stepX + builder.stepY * builder.stepY);
+
+    builder.request(0, 0);
+    builder.request(resolution, 0);
+    builder.request(resolution, resolution);
+    builder.request(0, resolution);
+    builder.evaluate(threads);
+
+    // Level by level: queue the probes of every cell, evaluate them in one
+    // parallel pass, then bound the error of every cell in parallel and
+    // split. Corners of a cell are always probes of its parent, so they are
+    // known when the cell is processed.
+    std::vector<ADFCell> leaves;
+    std::vector<ADFCell> level(1);
+    std::vector<ADFCell> nextLevel;
+    std::vector<int> probeIds;       // Row-major per cell, corners included
+    std::vector<unsigned char> splits;
+    level[0].node = 0;
+    level[0].ix = level[0].iy = 0;
+    level[0].size = resolution;
+    m_nodes.push_back(-1);
+
+    auto depthOf = [maxDepth](uint32_t size)
+    {
+        int depth = maxDepth;
+        for (; size > 1; size >>= 1)
+            depth--;
+        return depth;
+    };
+
+    // Build the subtrees of the cells in level (mixed depths allowed)
+    auto refine = [&]()
+    {
+        while (!level.empty())
+        {
+            for (size_t c = 0; c < level.size(); c++)
+            {
+                ADFCell& cell = level[c];
+                cell.probeStart = probeIds.size();
+                cell.probes = 0;
+                cell.verified = false;
+                cell.corners[0] = builder.findVertex(cell.ix, cell.iy);
+                cell.corners[1] = builder.findVertex(cell.ix + cell.size, cell.iy);
+                cell.corners[2] = builder.findVertex(cell.ix + cell.size, cell.iy + cell.size);
+                cell.corners[3] = builder.findVertex(cell.ix, cell.iy + cell.size);
+                if (cell.size < 2)
+                    continue;
+
+                // The boundary can only cross the cell if a corner is within one
+                // cell diagonal of it (the SDF is 1-Lipschitz): probe it finer
+                float nearest = std::fabs(builder.values[cell.corners[0]]);
+                for (int k = 1; k < 4; k++)
+                    nearest = std::min(nearest, std::fabs(builder.values[cell.corners[k]]));
+                cell.probes = (depthOf(cell.size) >= minDepth && nearest <= cell.size * latticeDiagonal &&
+                               cell.size >= 4) ? 4 : 2;
+
+                for (uint32_t j = 0; j <= cell.probes; j++)
+                {
+                    for (uint32_t i = 0; i <= cell.probes; i++)
+                        probeIds.push_back(builder.request(cell.ix + cell.size / cell.probes * i,
+                                                           cell.iy + cell.size / cell.probes * j));
+                }
+            }
+            builder.evaluate(threads);
+
+            splits.assign(level.size(), 0);
+            const int taskCount = static_cast<int>((level.size() + ADF_CELL_BLOCK - 1) / ADF_CELL_BLOCK);
+            ThreadPool::shared().parallelFor(taskCount, threads, [&](int task)
+            {
+                std::vector<int> nearby;
+                size_t end = std::min(level.size(), static_cast<size_t>(task + 1) * ADF_CELL_BLOCK);
+                for (size_t c = static_cast<size_t>(task) * ADF_CELL_BLOCK; c < end; c++)
+                {
+                    const ADFCell& cell = level[c];
+                    if (cell.probes == 0)
+                        continue;
+                    if (depthOf(cell.size) < minDepth)
+                    {
+                        splits[c] = 1;
+                        continue;
+                    }
+
+                    const float corners[4] = {
+                        builder.values[cell.corners[0]], builder.values[cell.corners[1]],
+                        builder.values[cell.corners[2]], builder.values[cell.corners[3]]
+                    };
+                    splits[c] = !cellWithinBound(builder, prepared, cell, cell.probes, &probeIds[cell.probeStart],
+                                                 corners, errorBound, nearby);
+                }
+            });
+
+            nextLevel.clear();
+            for (size_t c = 0; c < level.size(); c++)
+            {
+                const ADFCell& cell = level[c];
+                if (!splits[c])
+                {
+                    leaves.push_back(cell);
+                    m_maxDepth = std::max(m_maxDepth, depthOf(cell.size));
+                    continue;
+                }
+
+                const int firstChild = static_cast<int>(m_nodes.size());
+                m_nodes[cell.node] = firstChild;
+                m_nodes.resize(firstChild + 4, -1);
+
+                const uint32_t half = cell.size / 2;
+                for (int k = 0; k < 4; k++)
+                {
+                    ADFCell child = ADFCell();
+                    child.node = firstChild + k;
+                    child.ix = cell.ix + (k & 1) * half;
+                    child.iy = cell.iy + (k >> 1) * half;
+                    child.size = half;
+                    nextLevel.push_back(child);
+                }
+            }
+            level.swap(nextLevel);
+        }
+    };
+    refine();
+
+    // Make the field continuous across T-junctions: corners on the edge of a
+    // larger leaf are snapped onto that edge. Snapping moves a corner by the
+    // larger leaf's error, so leaves are checked again with their final
+    // corners; where the bound fails, the larger leaf that moved the corner
+    // (or the leaf itself) is split and everything is snapped again. Leaves
+    // whose corners kept their values since their last check are skipped.
+    std::vector<float> values;
+    std::vector<float> checkedValues;
+    std::vector<int> source;
+    std::vector<unsigned char> failed;
+    for (;;)
+    {
+        // Larger leaves first, so a leaf's own corners are final before its
+        // edges are processed
+        std::stable_sort(leaves.begin(), leaves.end(), [](const ADFCell& a, const ADFCell& b)
+        {
+            return a.size > b.size;
+        });
+
+        values = builder.values;
+        source.assign(values.size(), -1);
+        for (size_t k = 0; k < leaves.size(); k++)
+        {
+            const ADFCell& leaf = leaves[k];
+            const uint32_t x0 = leaf.ix, y0 = leaf.iy;
+            const uint32_t x1 = leaf.ix + leaf.size, y1 = leaf.iy + leaf.size;
+            const float v0 = values[leaf.corners[0]];
+            const float v1 = values[leaf.corners[1]];
+            const float v2 = values[leaf.corners[2]];
+            const float v3 = values[leaf.corners[3]];
+            const int id = static_cast<int>(k);
+
+            snapEdge(builder, values, source, id, x0, y0, v0, x1, y0, v1, leaf.size);  // Bottom
+            snapEdge(builder, values, source, id, x1, y0, v1, x1, y1, v2, leaf.size);  // Right
+            snapEdge(builder, values, source, id, x0, y1, v3, x1, y1, v2, leaf.size);  // Top
+            snapEdge(builder, values, source, id, x0, y0, v0, x0, y1, v3, leaf.size);  // Left
+        }
+
+        failed.assign(leaves.size(), 0);
+        const int taskCount = static_cast<int>((leaves.size() + ADF_CELL_BLOCK - 1) / ADF_CELL_BLOCK);
+        ThreadPool::shared().parallelFor(taskCount, threads, [&](int task)
+        {
+            std::vector<int> nearby;
+            size_t end = std::min(leaves.size(), static_cast<size_t>(task + 1) * ADF_CELL_BLOCK);
+            for (size_t k = static_cast<size_t>(task) * ADF_CELL_BLOCK; k < end; k++)
+            {
+                ADFCell& leaf = leaves[k];
+                const int* ids = leaf.corners;
+                const float corners[4] = {values[ids[0]], values[ids[1]], values[ids[2]], values[ids[3]]};
+
+                // Verified leaves passed with the last corners, the others
+                // with the exact ones in refine()
+                const std::vector<float>& checked = leaf.verified ? checkedValues : builder.values;
+                bool moved = false;
+                for (int c = 0; c < 4; c++)
+                    moved = moved || corners[c] != checked[ids[c]];
+                if (!moved)
+                    continue;
+
+                // Unsplittable leaves have no probes but their corners
+                const int cornerProbes[4] = {ids[0], ids[1], ids[3], ids[2]};
+                failed[k] = (leaf.probes > 0)
+                    ? !cellWithinBound(builder, prepared, leaf, leaf.probes, &probeIds[leaf.probeStart],
+                                       corners, errorBound, nearby)
+                    : !cellWithinBound(builder, prepared, leaf, 1, cornerProbes, corners, errorBound, nearby);
+                leaf.verified = !failed[k];
+            }
+        });
+
+        // Split the largest leaf that moved a corner of each failing leaf
+        std::vector<unsigned char> splitLeaf(leaves.size(), 0);
+        bool anySplit = false;
+        for (size_t k = 0; k < leaves.size(); k++)
+        {
+            if (!failed[k])
+                continue;
+
+            const ADFCell& leaf = leaves[k];
+            int target = -1;
+            for (int c = 0; c < 4; c++)
+            {
+                int from = source[leaf.corners[c]];
+                if (from >= 0 && (target < 0 || leaves[from].size > leaves[target].size))
+                    target = from;
+            }
+            if (target < 0 || leaves[target].size < 2)
+                target = static_cast<int>(k);
+            if (leaves[target].size >= 2 && !splitLeaf[target])
+            {
+                splitLeaf[target] = 1;
+                anySplit = true;
+            }
+        }
+        if (!anySplit)
+            break;
+        checkedValues.swap(values);
+
+        level.clear();
+        size_t kept = 0;
+        for (size_t k = 0; k < leaves.size(); k++)
+        {
+            const ADFCell& leaf = leaves[k];
+            if (!splitLeaf[k])
+            {
+                leaves[kept++] = leaf;
+                continue;
+            }
+
+            const int firstChild = static_cast<int>(m_nodes.size());
+            m_nodes[leaf.node] = firstChild;
+            m_nodes.resize(firstChild + 4, -1);
+
+            const uint32_t half = leaf.size / 2;
+            for (int c = 0; c < 4; c++)
+            {
+                ADFCell child = ADFCell();
+                child.node = firstChild + c;
+                child.ix = leaf.ix + (c & 1) * half;
+                child.iy = leaf.iy + (c >> 1) * half;
+                child.size = half;
+                level.push_back(child);
+            }
+        }
+        leaves.resize(kept);
+        refine();
+    }
+
+    // Keep the corner values per leaf (probe-only vertices are dropped)
+    m_values.resize(leaves.size() * 4);
+    for (size_t k = 0; k < leaves.size(); k++)
+    {
+        const ADFCell& leaf = leaves[k];
+        float* corners = &m_values[k * 4];
+        for (int c = 0; c < 4; c++)
+            corners[c] = values[leaf.corners[c]];
+        m_nodes[leaf.node] = -static_cast<int>(k) - 1;
+    }
+
+    m_nodes.shrink_to_fit();
+    return true;
+}
+
+float AdaptiveSDF::interpolate(int leaf, float u, float v) const
+{
+    const float* corners = &m_values[static_cast<size_t>(leaf) * 4];
+    return bilinear(corners[0], corners[1], corners[2], corners[3], u, v);
+}
+
+float AdaptiveSDF::sample(const Point2D& point) const
+{
+    if (!isValid())
+        return 0.0f;
+
+    // Normalized position in the region
+    float gx = clamp((point.x - m_worldMinX) / (m_worldMaxX - m_worldMinX), 0.0f, 1.0f);
+    float gy = clamp((point.y - m_worldMinY) / (m_worldMaxY - m_worldMinY), 0.0f, 1.0f);
+
+    int node = m_nodes[0];
+    float x0 = 0.0f, y0 = 0.0f, size = 1.0f;
+    while (node >= 0)
+    {
+        size *= 0.5f;
+        int right = (gx >= x0 + size) ? 1 : 0;
+        int top = (gy >= y0 + size) ? 1 : 0;
+        x0 += right * size;
+        y0 += top * size;
+        node = m_nodes[node + right + 2 * top];
+    }
+
+    return interpolate(-node - 1, clamp((gx - x0) / size, 0.0f, 1.0f),
+                       clamp((gy - y0) / size, 0.0f, 1.0f));
+}
+
+std::vector<Point2D> AdaptiveSDF::extractIsoContour(float isoValue) const
+{
+    std::vector<Point2D> contourPoints;
+    if (!isValid())
+        return contourPoints;
+
+    struct Cell {
+        int node;
+        float x0, y0, sizeX, sizeY;
+    };
+
+    std::vector<Cell> stack;
+    Cell root = {0, m_worldMinX, m_worldMinY, m_worldMaxX - m_worldMinX, m_worldMaxY - m_worldMinY};
+    stack.push_back(root);
+
+    while (!stack.empty())
+    {
+        Cell cell = stack.back();
+        stack.pop_back();
+        const int node = m_nodes[cell.node];
+
+        if (node < 0)
+        {
+            const float* corners = &m_values[static_cast<size_t>(-node - 1) * 4];
+            appendMarchingSquaresCell(corners[0], corners[1], corners[2], corners[3],
+                                      cell.x0, cell.x0 + cell.sizeX,
+                                      cell.y0, cell.y0 + cell.sizeY,
+                                      isoValue, contourPoints);
+            continue;
+        }
+
+        float halfX = 0.5f * cell.sizeX;
+        float halfY = 0.5f * cell.sizeY;
+        for (int k = 3; k >= 0; k--)
+        {
+            Cell child = {node + k,
+                          cell.x0 + (k & 1) * halfX, cell.y0 + (k >> 1) * halfY,
+                          halfX, halfY};
+            stack.push_back(child);
+        }
+    }
+
+    return contourPoints;
+}
+
+void AdaptiveSDF::getFinestCellSize(float& outSizeX, float& outSizeY) const
+{
+    float scale = 1.0f / static_cast<float>(1u << m_maxDepth);
+    outSizeX = (m_worldMaxX - m_worldMinX) * scale;
+    outSizeY = (m_worldMaxY - m_worldMinY) * scale;
+}
+
+size_t AdaptiveSDF::getMemoryUsage() const
+{
+    return m_nodes.capacity() * sizeof(int) + m_values.capacity() * sizeof(float);
+}
@@ -0,0 +1,358 @@
+#include "EdgeBVH.h"
+#include "sdf_backends.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+// Deeper than any median-split tree over 2^31 edges
+static const int MAX_STACK_DEPTH = 64;
+
+EdgeBVH::EdgeBVH()
+    : m_buildTimeMs(0.0)
+{
+}
+
+void EdgeBVH::clear()
+{
+    m_nodes.clear();
+    m_edges = PreparedPolygon();
+    m_edgeIndex.clear();
+    m_buildTimeMs = 0.0;
+}
+
+void EdgeBVH::build(const PreparedPolygon& prepared)
+{
+    clear();
+    if (prepared.edgeCount < 3)
+        return;
+
+    auto startTime = std::chrono::steady_clock::now();
+    const int n = prepared.edgeCount;
+
+    std::vector<int> order(n);
+    std::vector<float> centerX(n), centerY(n);
+    for (int i = 0; i < n; i++)
+    {
+        order[i] = i;
+        centerX[i] = prepared.originX[i] + 0.5f * prepared.dirX[i];
+        centerY[i] = prepared.originY[i] + 0.5f * prepared.dirY[i];
+    }
+
+    // Leaves hold at least two edges, so there are fewer than n nodes
+    m_nodes.reserve(n);
+    buildNode(order, 0, n, centerX, centerY, prepared);
+    m_nodes.shrink_to_fit();
+
+    // Copy the edges in leaf order so that leaves read contiguous memory
+    m_edges.originX.resize(n);
+    m_edges.originY.resize(n);
+    m_edges.dirX.resize(n);
+    m_edges.dirY.resize(n);
+    m_edges.invLengthSq.resize(n);
+    m_edges.minY.resize(n);
+    m_edges.maxY.resize(n);
+    m_edges.edgeCount = n;
+    m_edgeIndex = order;
+
+    for (int k = 0; k < n; k++)
+    {
+        int i = order[k];
+        m_edges.originX[k] = prepared.originX[i];
+        m_edges.originY[k] = prepared.originY[i];
+        m_edges.dirX[k] = prepared.dirX[i];
+        m_edges.dirY[k] = prepared.dirY[i];
+        m_edges.invLengthSq[k] = prepared.invLengthSq[i];
+        m_edges.minY[k] = prepared.minY[i];
+        m_edges.maxY[k] = prepared.maxY[i];
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    m_buildTimeMs = elapsed.count();
+}
+
+int EdgeBVH::buildNode(std::vector<int>& order, int begin, int end,
+                       const std::vector<float>& centerX,
+                       const std::vector<float>& centerY,
+                       const PreparedPolygon& prepared)
+{
+    const int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    // Bounds of the edges and of their centers
+    Node node;
+    node.minX = node.minY = std::numeric_limits<float>::max();
+    node.maxX = node.maxY = -std::numeric_limits<float>::max();
+    float centerMinX = node.minX, centerMinY = node.minY;
+    float centerMaxX = node.maxX, centerMaxY = node.maxY;
+
+    for (int k = begin; k < end; k++)
+    {
+        int i = order[k];
+        float x0 = prepared.originX[i];
+        float x1 = prepared.originX[i] + prepared.dirX[i];
+        node.minX = std::min(node.minX, std::min(x0, x1));
+        node.maxX = std::max(node.maxX, std::max(x0, x1));
+        node.minY = std::min(node.minY, prepared.minY[i]);
+        node.maxY = std::max(node.maxY, prepared.maxY[i]);
+
+        centerMinX = std::min(centerMinX, centerX[i]);
+        centerMaxX = std::max(centerMaxX, centerX[i]);
+        centerMinY = std::min(centerMinY, centerY[i]);
+        centerMaxY = std::max(centerMaxY, centerY[i]);
+    }
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        node.start = begin;
+        node.count = end - begin;
+        m_nodes[nodeIndex] = node;
+        return nodeIndex;
+    }
+
+    // Median split along the longer axis of the centers
+    const int middle = begin + (end - begin) / 2;
+    if (centerMaxX - centerMinX >= centerMaxY - centerMinY)
+    {
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                         [&](int a, int b) { return centerX[a] < centerX[b]; });
+    }
+    else
+    {
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                         [&](int a, int b) { return centerY[a] < centerY[b]; });
+    }
+
+    buildNode(order, begin, middle, centerX, centerY, prepared);
+    node.start = buildNode(order, middle, end, centerX, centerY, prepared);
+    node.count = 0;
+    m_nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+/**
+ * @brief Squared distance from a point to a node box (0 inside)
+ */
+static inline float boxDistanceSq(float px, float py,
+                                  float minX, float minY, float maxX, float maxY)
+{
+    float dx = std::max(std::max(minX - px, px - maxX), 0.0f);
+    float dy = std::max(std::max(minY - py, py - maxY), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+float EdgeBVH::distance(const Point2D& p, int* outEdge) const
+{
+    if (!isValid())
+    {
+        if (outEdge != nullptr)
+            *outEdge = -1;
+        return std::numeric_limits<float>::max();
+    }
+
+    float bestDistSq;
+    int bestEdge = nearestEdge(p, bestDistSq);
+    if (outEdge != nullptr)
+        *outEdge = (bestEdge < 0) ? -1 : m_edgeIndex[bestEdge];
+    return std::sqrt(bestDistSq);
+}
+
+int EdgeBVH::nearestEdge(const Point2D& p, float& outDistSq) const
+{
+    float bestDistSq = std::numeric_limits<float>::max();
+    int bestEdge = -1;
+
+    // Box distances are shrunk slightly before pruning so that float
+    // rounding of the bounds can never skip the nearest edge
+    const float pruneScale = 1.0f - 1e-5f;
+
+    int stack[MAX_STACK_DEPTH];
+    float stackDistSq[MAX_STACK_DEPTH];
+    int top = 0;
+    stack[top] = 0;
+    stackDistSq[top++] = 0.0f;
+
+    while (top > 0)
+    {
+        top--;
+        if (stackDistSq[top] * pruneScale > bestDistSq)
+            continue;
+
+        const Node& node = m_nodes[stack[top]];
+        if (node.count > 0)
+        {
+            for (int k = node.start; k < node.start + node.count; k++)
+            {
+                float pax = p.x - m_edges.originX[k];
+                float pay = p.y - m_edges.originY[k];
+                float t = clamp((pax * m_edges.dirX[k] + pay * m_edges.dirY[k]) * m_edges.invLengthSq[k], 0.0f, 1.0f);
+                float ex = pax - m_edges.dirX[k] * t;
+                float ey = pay - m_edges.dirY[k] * t;
+                float distSq = ex * ex + ey * ey;
+                if (distSq < bestDistSq)
+                {
+                    bestDistSq = distSq;
+                    bestEdge = k;
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is visited next
+        int left = stack[top] + 1;
+        int right = node.start;
+        const Node& a = m_nodes[left];
+        const Node& b = m_nodes[right];
+        float leftDistSq = boxDistanceSq(p.x, p.y, a.minX, a.minY, a.maxX, a.maxY);
+        float rightDistSq = boxDistanceSq(p.x, p.y, b.minX, b.minY, b.maxX, b.maxY);
+
+        if (leftDistSq > rightDistSq)
+        {
+            std::swap(left, right);
+            std::swap(leftDistSq, rightDistSq);
+        }
+        if (rightDistSq * pruneScale <= bestDistSq)
+        {
+            stack[top] = right;
+            stackDistSq[top++] = rightDistSq;
+        }
+        if (leftDistSq * pruneScale <= bestDistSq)
+        {
+            stack[top] = left;
+            stackDistSq[top++] = leftDistSq;
+        }
+    }
+
+    outDistSq = bestDistSq;
+    return bestEdge;
+}
+
+void EdgeBVH::edgesWithin(const Point2D& p, float radius, std::vector<int>& outEdges) const
+{
+    outEdges.clear();
+    if (!isValid() || !(radius >= 0.0f))
+        return;
+
+    const float radiusSq = radius * radius;
+    int stack[MAX_STACK_DEPTH];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const int index = stack[--top];
+        const Node& node = m_nodes[index];
+        if (boxDistanceSq(p.x, p.y, node.minX, node.minY, node.maxX, node.maxY) > radiusSq)
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.start;
+            stack[top++] = index + 1;
+            continue;
+        }
+
+        for (int k = node.start; k < node.start + node.count; k++)
+        {
+            if (preparedEdgeDistance(m_edges, k, p.x, p.y) <= radius)
+                outEdges.push_back(m_edgeIndex[k]);
+        }
+    }
+}
+
+bool EdgeBVH::isInside(const Point2D& p) const
+{
+    if (!isValid())
+        return false;
+
+    int winding = 0;
+    int stack[MAX_STACK_DEPTH];
+    int top = 0;
+    stack[top++] = 0;
+
+    // Only edges crossing the line y = p.y and reaching x >= p.x can count
+    while (top > 0)
+    {
+        const Node& node = m_nodes[stack[--top]];
+        if (p.y < node.minY || p.y > node.maxY || node.maxX < p.x)
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.start;
+            stack[top++] = static_cast<int>(&node - m_nodes.data()) + 1;
+            continue;
+        }
+
+        // Same crossing rules as calculatePreparedSDF()
+        for (int k = node.start; k < node.start + node.count; k++)
+        {
+            if (p.y >= m_edges.minY[k] && p.y < m_edges.maxY[k])
+            {
+                float pax = p.x - m_edges.originX[k];
+                float pay = p.y - m_edges.originY[k];
+                float cross = m_edges.dirX[k] * pay - pax * m_edges.dirY[k];
+                if (m_edges.dirY[k] > 0)
+                {
+                    if (cross > 0)
+                        winding++;
+                }
+                else if (cross < 0)
+                {
+                    winding--;
+                }
+            }
+        }
+    }
+
+    return winding != 0;
+}
+
+float EdgeBVH::signedDistance(const Point2D& p) const
+{
+    if (!isValid())
+        return std::numeric_limits<float>::max();
+
+    float dist = distance(p);
+    return isInside(p) ? -dist : dist;
+}
+
+float EdgeBVH::signedDistance(const Point2D& p, Point2D& outGradient) const
+{
+    outGradient.x = 0.0f;
+    outGradient.y = 0.0f;
+    if (!isValid())
+        return std::numeric_limits<float>::max();
+
+    float distSq;
+    int k = nearestEdge(p, distSq);
+    float dist = std::sqrt(distSq);
+    bool inside = isInside(p);
+    if (k < 0)
+        return inside ? -dist : dist;
+
+    if (!isOnBoundary(p, dist, std::fabs(m_edges.dirX[k]) + std::fabs(m_edges.dirY[k])))
+    {
+        // Offset from the nearest point, recomputed as in the traversal
+        float pax = p.x - m_edges.originX[k];
+        float pay = p.y - m_edges.originY[k];
+        float t = clamp((pax * m_edges.dirX[k] + pay * m_edges.dirY[k]) * m_edges.invLengthSq[k], 0.0f, 1.0f);
+        outGradient = offsetGradient(pax - m_edges.dirX[k] * t, pay - m_edges.dirY[k] * t,
+                                     dist, inside);
+    }
+    else
+    {
+        outGradient = boundaryGradient(m_edges, k, p, [this](const Point2D& q)
+        {
+            return isInside(q);
+        });
+    }
+    return inside ? -dist : dist;
+}
+
+size_t EdgeBVH::getMemoryUsage() const
+{
+    return m_nodes.capacity() * sizeof(Node) +
+           m_edgeIndex.capacity() * sizeof(int) +
+           static_cast<size_t>(m_edges.edgeCount) * 7 * sizeof(float);
+}
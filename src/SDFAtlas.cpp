@@ -0,0 +1,294 @@
+#include "SDFAtlas.h"
+#include "ThreadPool.h"
+#include "sdf_simd.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace
+{
+
+/**
+ * @brief Skyline bottom-left rectangle packer for one page
+ *
+ * The skyline is a list of horizontal segments covering the page width;
+ * a rectangle goes where its top ends lowest, resting on the highest
+ * segment below its span. Space under the skyline is never reused.
+ */
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height)
+        : m_width(width), m_height(height)
+    {
+        Node node = {0, 0, width};
+        m_nodes.push_back(node);
+    }
+
+    bool insert(int width, int height, int& outX, int& outY)
+    {
+        int bestTop = m_height + 1;
+        int bestSegment = m_width + 1;
+        size_t bestIndex = 0;
+        int bestY = 0;
+        for (size_t i = 0; i < m_nodes.size(); i++)
+        {
+            int y = fit(i, width, height);
+            if (y < 0)
+                continue;
+
+            // Lowest top first, then the narrowest segment to rest on
+            int top = y + height;
+            if (top < bestTop || (top == bestTop && m_nodes[i].width < bestSegment))
+            {
+                bestTop = top;
+                bestSegment = m_nodes[i].width;
+                bestIndex = i;
+                bestY = y;
+            }
+        }
+        if (bestTop > m_height)
+            return false;
+
+        outX = m_nodes[bestIndex].x;
+        outY = bestY;
+        Node node = {outX, bestY + height, width};
+        m_nodes.insert(m_nodes.begin() + bestIndex, node);
+
+        // Cut the segments now under the new one
+        size_t i = bestIndex + 1;
+        while (i < m_nodes.size() && m_nodes[i].x < outX + width)
+        {
+            int shrink = outX + width - m_nodes[i].x;
+            if (shrink < m_nodes[i].width)
+            {
+                m_nodes[i].x += shrink;
+                m_nodes[i].width -= shrink;
+                break;
+            }
+            m_nodes.erase(m_nodes.begin() + i);
+        }
+
+        // Merge neighbours at the same height
+        for (i = 0; i + 1 < m_nodes.size();)
+        {
+            if (m_nodes[i].y == m_nodes[i + 1].y)
+            {
+                m_nodes[i].width += m_nodes[i + 1].width;
+                m_nodes.erase(m_nodes.begin() + i + 1);
+            }
+            else
+            {
+                i++;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Node {
+        int x, y, width;
+    };
+
+    // Bottom of a rectangle placed at the left end of segment i, -1 if it does not fit
+    int fit(size_t i, int width, int height) const
+    {
+        if (m_nodes[i].x + width > m_width)
+            return -1;
+
+        int y = 0;
+        int remaining = width;
+        for (size_t j = i; remaining > 0; j++)
+        {
+            y = std::max(y, m_nodes[j].y);
+            if (y + height > m_height)
+                return -1;
+            remaining -= m_nodes[j].width;
+        }
+        return y;
+    }
+
+    int m_width, m_height;
+    std::vector<Node> m_nodes;
+};
+
+/**
+ * @brief Rows [rowBegin, rowEnd) of one region
+ */
+struct AtlasTask {
+    int region;
+    int rowBegin, rowEnd;
+};
+
+} // namespace
+
+SDFAtlas::SDFAtlas(const SDFAtlasConfig& config)
+    : m_config(config)
+    , m_pageCount(0)
+    , m_pageWidth(0)
+    , m_pageHeight(0)
+    , m_lastBuildTimeMs(0.0)
+{
+}
+
+const float* SDFAtlas::getPage(int page) const
+{
+    if (page < 0 || page >= m_pageCount)
+        return nullptr;
+    return m_texels.data() + static_cast<size_t>(page) * m_pageWidth * m_pageHeight;
+}
+
+float SDFAtlas::getOccupancy() const
+{
+    if (m_pageCount == 0)
+        return 0.0f;
+
+    double covered = 0.0;
+    for (const SDFAtlasRegion& region : m_regions)
+    {
+        if (region.isValid)
+            covered += static_cast<double>(region.width) * region.height;
+    }
+    return static_cast<float>(covered / (static_cast<double>(m_pageCount) * m_pageWidth * m_pageHeight));
+}
+
+bool SDFAtlas::build(const std::vector<SDFAtlasShape>& shapes)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    const int pageWidth = std::max(1, m_config.pageWidth);
+    const int pageHeight = std::max(1, m_config.pageHeight);
+    const int spacing = std::max(0, m_config.spacing);
+    const int threads = ThreadPool::resolveThreadCount(m_config.threadCount);
+    m_pageWidth = pageWidth;
+    m_pageHeight = pageHeight;
+    m_pageCount = 0;
+    m_regions.assign(shapes.size(), SDFAtlasRegion());
+
+    // Prepare the polygons and size the regions
+    std::vector<PreparedPolygon> prepared(shapes.size());
+    ThreadPool::shared().parallelFor(static_cast<int>(shapes.size()), threads, [&](int i)
+    {
+        const SDFAtlasShape& shape = shapes[i];
+        SDFAtlasRegion& region = m_regions[i];
+        if (shape.polygon.size() < 3 || !(shape.pixelSize > 0.0f))
+            return;
+
+        preparePolygon(shape.polygon, prepared[i]);
+
+        float minX, maxX, minY, maxY;
+        ::calculatePolygonBounds(shape.polygon, minX, maxX, minY, maxY);
+        float rangeX = maxX - minX + 2.0f * shape.padding;
+        float rangeY = maxY - minY + 2.0f * shape.padding;
+        region.width = static_cast<int>(rangeX / shape.pixelSize) + 1;
+        region.height = static_cast<int>(rangeY / shape.pixelSize) + 1;
+
+        // Whole texels of pixelSize, centered on the padded bounds
+        region.minX = minX - shape.padding - 0.5f * (region.width * shape.pixelSize - rangeX);
+        region.minY = minY - shape.padding - 0.5f * (region.height * shape.pixelSize - rangeY);
+        region.maxX = region.minX + region.width * shape.pixelSize;
+        region.maxY = region.minY + region.height * shape.pixelSize;
+        region.scale = 1.0f / shape.pixelSize;
+    });
+
+    // Tallest first, then widest: the skyline stays flat
+    std::vector<int> order;
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        const SDFAtlasRegion& region = m_regions[i];
+        if (region.width > 0 && region.width <= pageWidth && region.height <= pageHeight)
+            order.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        if (m_regions[a].height != m_regions[b].height)
+            return m_regions[a].height > m_regions[b].height;
+        return m_regions[a].width > m_regions[b].width;
+    });
+
+    // Every region is packed with spacing texels to its right and top; the
+    // packers are that much larger so regions can still reach the far edges
+    std::vector<SkylinePacker> packers;
+    for (int i : order)
+    {
+        SDFAtlasRegion& region = m_regions[i];
+        int page = 0;
+        for (; page < static_cast<int>(packers.size()); page++)
+        {
+            if (packers[page].insert(region.width + spacing, region.height + spacing,
+                                     region.x, region.y))
+                break;
+        }
+        if (page == static_cast<int>(packers.size()))
+        {
+            packers.push_back(SkylinePacker(pageWidth + spacing, pageHeight + spacing));
+            packers.back().insert(region.width + spacing, region.height + spacing,
+                                  region.x, region.y);
+        }
+
+        region.page = page;
+        region.u0 = static_cast<float>(region.x) / pageWidth;
+        region.v0 = static_cast<float>(region.y) / pageHeight;
+        region.u1 = static_cast<float>(region.x + region.width) / pageWidth;
+        region.v1 = static_cast<float>(region.y + region.height) / pageHeight;
+        region.offsetX = region.x - region.minX * region.scale;
+        region.offsetY = region.y - region.minY * region.scale;
+        region.isValid = true;
+    }
+    m_pageCount = static_cast<int>(packers.size());
+
+    // One allocation for every page; texels outside the regions keep emptyValue
+    const size_t pageSize = static_cast<size_t>(pageWidth) * pageHeight;
+    m_texels.assign(pageSize * m_pageCount, m_config.emptyValue);
+
+    // Split regions into row runs of similar cost (width x edges per row), so
+    // one pass over all of them balances big and small shapes
+    double totalCost = 0.0;
+    for (int i : order)
+        totalCost += static_cast<double>(m_regions[i].width) * m_regions[i].height * prepared[i].edgeCount;
+    const double taskCost = std::max(1.0, totalCost / (threads * 16.0));
+
+    std::vector<AtlasTask> tasks;
+    for (int i : order)
+    {
+        const SDFAtlasRegion& region = m_regions[i];
+        double rowCost = static_cast<double>(region.width) * prepared[i].edgeCount;
+        int rowsPerTask = static_cast<int>(std::min<double>(region.height,
+                                                            std::max(1.0, taskCost / rowCost)));
+        for (int rowBegin = 0; rowBegin < region.height; rowBegin += rowsPerTask)
+        {
+            AtlasTask task = {i, rowBegin, std::min(rowBegin + rowsPerTask, region.height)};
+            tasks.push_back(task);
+        }
+    }
+
+    SDFRowKernel rowKernel = m_config.useSIMD ? getSDFRowKernel() : computeSDFRowScalar;
+    const float maxDistance = m_config.maxDistance;
+
+    ThreadPool::shared().parallelFor(static_cast<int>(tasks.size()), threads, [&](int t)
+    {
+        const AtlasTask& task = tasks[t];
+        const SDFAtlasRegion& region = m_regions[task.region];
+
+        // Same sample positions as generateSDFGrid() over the region's extent
+        float stepX = (region.maxX - region.minX) / region.width;
+        float stepY = (region.maxY - region.minY) / region.height;
+        float* page = m_texels.data() + region.page * pageSize;
+
+        for (int y = task.rowBegin; y < task.rowEnd; y++)
+        {
+            float* row = page + static_cast<size_t>(region.y + y) * pageWidth + region.x;
+            rowKernel(prepared[task.region], region.minX, stepX, region.minY + (y + 0.5f) * stepY,
+                      region.width, row, nullptr);
+
+            if (maxDistance > 0.0f)
+            {
+                for (int x = 0; x < region.width; x++)
+                    row[x] = clamp(row[x], -maxDistance, maxDistance);
+            }
+        }
+    });
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    m_lastBuildTimeMs = elapsed.count();
+    return order.size() == shapes.size();
+}
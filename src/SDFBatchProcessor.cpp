@@ -0,0 +1,156 @@
+#include "SDFBatchProcessor.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+/**
+ * @brief A run of consecutive items processed by one task
+ */
+struct BatchTask {
+    size_t first, count;
+    double cost;
+    bool large;  // Single item whose grid is split over several threads
+};
+
+} // namespace
+
+SDFBatchProcessor::SDFBatchProcessor(const SDFConfig& config)
+    : m_config(config)
+    , m_lastJobTimeMs(0.0)
+    , m_lastTaskCount(0)
+{
+}
+
+double SDFBatchProcessor::estimateCost(const std::vector<Point2D>& polygon) const
+{
+    if (polygon.size() < 3)
+        return 1.0;
+
+    // Grid size as SDFProcessor::computeGridExtent() would choose it
+    float minX, maxX, minY, maxY;
+    ::calculatePolygonBounds(polygon, minX, maxX, minY, maxY);
+    int width = static_cast<int>((maxX - minX + 2.0f * m_config.padding) / m_config.gridSize) + 1;
+    int height = static_cast<int>((maxY - minY + 2.0f * m_config.padding) / m_config.gridSize) + 1;
+    width = std::min(width, m_config.maxGridSize);
+    height = std::min(height, m_config.maxGridSize);
+
+    double samples = static_cast<double>(width) * height;
+    double edges = static_cast<double>(polygon.size());
+    if (m_config.storage == SDFStorage::Dense && m_config.gridMethod == SDFGridMethod::Exact)
+        return samples * edges;
+    return samples + edges;
+}
+
+/**
+ * @brief Run the requested operations on one item
+ */
+static void processItem(SDFProcessor& processor, const SDFBatchItem& item,
+                        SDFBatchItemResult& result)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    result.contour.isValid = false;
+    result.ring.triangleCount = 0;
+    result.ring.isValid = false;
+    result.isValid = processor.setPolygon(item.polygon);
+
+    if (result.isValid && (item.operations & SDFBatchGrid))
+    {
+        result.grid = processor.updateGridSnapshot();
+        result.isValid = result.grid != nullptr;
+    }
+
+    if (result.isValid && (item.operations & SDFBatchContour))
+        result.isValid = processor.extractContour(item.contourThreshold, result.contour);
+
+    if (result.isValid && (item.operations & SDFBatchRing))
+    {
+        result.isValid = processor.generateRing(item.ringOuterThreshold, item.ringInnerThreshold,
+                                                result.ring);
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    result.timeMs = elapsed.count();
+}
+
+std::vector<SDFBatchItemResult> SDFBatchProcessor::process(const std::vector<SDFBatchItem>& items)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<SDFBatchItemResult> results(items.size());
+    m_lastTaskCount = 0;
+    if (items.empty())
+    {
+        m_lastJobTimeMs = 0.0;
+        return results;
+    }
+
+    std::vector<double> costs(items.size());
+    double totalCost = 0.0;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        costs[i] = estimateCost(items[i].polygon);
+        totalCost += costs[i];
+    }
+
+    // Items above largeCost get their own task with a multi-threaded grid;
+    // the rest are grouped up to chunkCost per task
+    const int threads = ThreadPool::resolveThreadCount(m_config.threadCount);
+    const double largeCost = totalCost / (threads * 4.0);
+    const double chunkCost = totalCost / (threads * 16.0);
+
+    std::vector<BatchTask> tasks;
+    BatchTask chunk = {0, 0, 0.0, false};
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (costs[i] >= largeCost && threads > 1)
+        {
+            BatchTask large = {i, 1, costs[i], true};
+            tasks.push_back(large);
+            continue;
+        }
+
+        // Items in a chunk are consecutive
+        if (chunk.count > 0 && (chunk.first + chunk.count != i || chunk.cost + costs[i] > chunkCost))
+        {
+            tasks.push_back(chunk);
+            chunk.count = 0;
+        }
+        if (chunk.count == 0)
+        {
+            chunk.first = i;
+            chunk.cost = 0.0;
+        }
+        chunk.count++;
+        chunk.cost += costs[i];
+    }
+    if (chunk.count > 0)
+        tasks.push_back(chunk);
+
+    // Most expensive first: big items start early and the cheap chunks
+    // fill the gaps at the end
+    std::stable_sort(tasks.begin(), tasks.end(), [](const BatchTask& a, const BatchTask& b)
+    {
+        return a.cost > b.cost;
+    });
+    m_lastTaskCount = static_cast<int>(tasks.size());
+
+    SDFConfig largeConfig = m_config;
+    SDFConfig smallConfig = m_config;
+    smallConfig.threadCount = 1;
+
+    ThreadPool::shared().parallelFor(static_cast<int>(tasks.size()), threads, [&](int t)
+    {
+        const BatchTask& task = tasks[t];
+        SDFProcessor processor(task.large ? largeConfig : smallConfig);
+        for (size_t i = task.first; i < task.first + task.count; i++)
+            processItem(processor, items[i], results[i]);
+    });
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    m_lastJobTimeMs = elapsed.count();
+    return results;
+}
@@ -0,0 +1,767 @@
+#include "SDFGridFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char FILE_MAGIC[8] = {'S', 'D', 'F', 'G', 'R', 'I', 'D', '\0'};
+static const uint32_t FILE_VERSION = 2;      // 2: polygon hash
+static const uint32_t FIRST_FILE_VERSION = 1; // Same layout, hash bytes reserved (zero)
+static const uint32_t BYTE_ORDER_MARK = 0x01020304u;
+static const uint64_t DATA_ALIGNMENT = 64;
+
+namespace
+{
+
+/**
+ * @brief On-disk header, 128 bytes
+ */
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t byteOrder;
+    uint32_t valueType;
+    int32_t width, height;
+    float minX, maxX;
+    float minY, maxY;
+    uint32_t compression;
+    int32_t tileSize;
+    uint32_t gridMethod;
+    float gridSize;
+    float padding;
+    float maxDistance;
+    int32_t maxGridSize;
+    uint32_t reserved0;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t polygonHash;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(FileHeader) == 128, "grid file header must be 128 bytes");
+
+/**
+ * @brief A read-only file mapping, unmapped on destruction
+ */
+struct FileMapping {
+    const unsigned char* base;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    FileMapping() : base(nullptr), size(0)
+#if defined(_WIN32)
+        , file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+    {
+    }
+
+    ~FileMapping()
+    {
+#if defined(_WIN32)
+        if (base != nullptr)
+            UnmapViewOfFile(base);
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (base != nullptr)
+            munmap(const_cast<unsigned char*>(base), size);
+#endif
+    }
+};
+
+} // namespace
+
+static int tileCountOf(const FileHeader& header)
+{
+    int tilesX = (header.width + header.tileSize - 1) / header.tileSize;
+    int tilesY = (header.height + header.tileSize - 1) / header.tileSize;
+    return tilesX * tilesY;
+}
+
+/**
+ * @brief Check a header against the file size
+ */
+static bool validateHeader(const FileHeader& header, uint64_t fileSize)
+{
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+    {
+        std::cerr << "SDFGridFile: Not a grid file" << std::endl;
+        return false;
+    }
+    if (header.version < FIRST_FILE_VERSION || header.version > FILE_VERSION ||
+        header.headerSize != sizeof(FileHeader))
+    {
+        std::cerr << "SDFGridFile: Unsupported version " << header.version << std::endl;
+        return false;
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK)
+    {
+        std::cerr << "SDFGridFile: File written with a different byte order" << std::endl;
+        return false;
+    }
+
+    const uint64_t sampleBytes = static_cast<uint64_t>(header.width) * header.height * sizeof(float);
+    bool valid = header.valueType == static_cast<uint32_t>(SDFGridValueType::Float32) &&
+                 header.width >= 2 && header.height >= 2 &&
+                 header.dataOffset >= sizeof(FileHeader) &&
+                 header.dataOffset % DATA_ALIGNMENT == 0 &&
+                 header.dataOffset <= fileSize &&
+                 header.dataSize <= fileSize - header.dataOffset;
+    if (valid && header.compression == static_cast<uint32_t>(SDFGridCompression::None))
+    {
+        valid = header.dataSize == sampleBytes;
+    }
+    else if (valid && header.compression == static_cast<uint32_t>(SDFGridCompression::Tiles))
+    {
+        valid = header.tileSize > 0 &&
+                header.dataSize >= (static_cast<uint64_t>(tileCountOf(header)) + 1) * sizeof(uint64_t);
+    }
+    else
+    {
+        valid = false;
+    }
+
+    if (!valid)
+        std::cerr << "SDFGridFile: Corrupt header" << std::endl;
+    return valid;
+}
+
+static void headerToInfo(const FileHeader& header, SDFGridFileInfo& info)
+{
+    info.version = static_cast<int>(header.version);
+    info.width = header.width;
+    info.height = header.height;
+    info.minX = header.minX;
+    info.maxX = header.maxX;
+    info.minY = header.minY;
+    info.maxY = header.maxY;
+    info.valueType = static_cast<SDFGridValueType>(header.valueType);
+    info.compression = static_cast<SDFGridCompression>(header.compression);
+    info.tileSize = header.tileSize;
+    info.gridMethod = static_cast<SDFGridMethod>(header.gridMethod);
+    info.gridSize = header.gridSize;
+    info.padding = header.padding;
+    info.maxDistance = header.maxDistance;
+    info.maxGridSize = header.maxGridSize;
+    info.polygonHash = header.version >= 2 ? header.polygonHash : 0;
+}
+
+/**
+ * @brief A file next to path that is not in use, for writing before
+ *        replacePath()
+ */
+static std::string temporaryPath(const std::string& path)
+{
+    static std::atomic<unsigned> counter(0);
+#if defined(_WIN32)
+    unsigned long process = GetCurrentProcessId();
+#else
+    unsigned long process = static_cast<unsigned long>(getpid());
+#endif
+    return path + ".tmp" + std::to_string(process) + "-" + std::to_string(counter++);
+}
+
+/**
+ * @brief Move a finished file over path in one step
+ *
+ * Existing mappings and open handles of the old file keep its contents,
+ * and readers never see a partly written file. The temporary file is
+ * removed on failure.
+ */
+static bool replacePath(const std::string& temporary, const std::string& path)
+{
+#if defined(_WIN32)
+    bool replaced = MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool replaced = std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+    if (!replaced)
+    {
+        std::remove(temporary.c_str());
+        std::cerr << "SDFGridFile: Cannot replace " << path << std::endl;
+    }
+    return replaced;
+}
+
+/**
+ * @brief PackBits: control c < 128 copies c + 1 literal bytes, c > 128
+ *        repeats the next byte 257 - c times
+ */
+static void packBits(const unsigned char* in, size_t n, std::vector<unsigned char>& out)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t run = 1;
+        while (i + run < n && run < 128 && in[i + run] == in[i])
+            run++;
+        if (run >= 2)
+        {
+            out.push_back(static_cast<unsigned char>(257 - run));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        // Literals up to the next pair of equal bytes
+        size_t start = i;
+        while (i < n && i - start < 128 && !(i + 1 < n && in[i] == in[i + 1]))
+            i++;
+        out.push_back(static_cast<unsigned char>(i - start - 1));
+        out.insert(out.end(), in + start, in + i);
+    }
+}
+
+static bool unpackBits(const unsigned char*& in, const unsigned char* end,
+                       unsigned char* out, size_t n)
+{
+    size_t produced = 0;
+    while (produced < n)
+    {
+        if (in >= end)
+            return false;
+        unsigned int control = *in++;
+        if (control < 128)
+        {
+            size_t count = control + 1;
+            if (count > n - produced || count > static_cast<size_t>(end - in))
+                return false;
+            std::memcpy(out + produced, in, count);
+            in += count;
+            produced += count;
+        }
+        else if (control > 128)
+        {
+            size_t count = 257 - control;
+            if (count > n - produced || in >= end)
+                return false;
+            std::memset(out + produced, *in++, count);
+            produced += count;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Compress one tile: XOR with the left (or upper) neighbour, then
+ *        PackBits per byte plane
+ */
+static void encodeTile(const float* data, int width, int x0, int y0, int tileWidth, int tileHeight,
+                       std::vector<unsigned char>& out)
+{
+    const size_t count = static_cast<size_t>(tileWidth) * tileHeight;
+    std::vector<unsigned char> planes(count * 4);
+
+    size_t k = 0;
+    for (int y = y0; y < y0 + tileHeight; y++)
+    {
+        for (int x = x0; x < x0 + tileWidth; x++, k++)
+        {
+            uint32_t predicted = 0;
+            if (x > x0)
+                predicted = floatBits(data[y * width + x - 1]);
+            else if (y > y0)
+                predicted = floatBits(data[(y - 1) * width + x]);
+
+            uint32_t residual = floatBits(data[y * width + x]) ^ predicted;
+            for (int b = 0; b < 4; b++)
+                planes[b * count + k] = static_cast<unsigned char>(residual >> (8 * b));
+        }
+    }
+
+    for (int b = 0; b < 4; b++)
+        packBits(&planes[b * count], count, out);
+}
+
+static bool decodeTile(const unsigned char* in, const unsigned char* end,
+                       float* data, int width, int x0, int y0, int tileWidth, int tileHeight)
+{
+    const size_t count = static_cast<size_t>(tileWidth) * tileHeight;
+    std::vector<unsigned char> planes(count * 4);
+    for (int b = 0; b < 4; b++)
+    {
+        if (!unpackBits(in, end, &planes[b * count], count))
+            return false;
+    }
+
+    size_t k = 0;
+    for (int y = y0; y < y0 + tileHeight; y++)
+    {
+        for (int x = x0; x < x0 + tileWidth; x++, k++)
+        {
+            uint32_t predicted = 0;
+            if (x > x0)
+                predicted = floatBits(data[y * width + x - 1]);
+            else if (y > y0)
+                predicted = floatBits(data[(y - 1) * width + x]);
+
+            uint32_t residual = 0;
+            for (int b = 0; b < 4; b++)
+                residual |= static_cast<uint32_t>(planes[b * count + k]) << (8 * b);
+
+            uint32_t bits = residual ^ predicted;
+            std::memcpy(&data[y * width + x], &bits, sizeof(bits));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Decode a tiled payload into width * height samples
+ */
+static bool decodeTiles(const FileHeader& header, const unsigned char* payload, float* data)
+{
+    const int tileSize = header.tileSize;
+    const int tilesX = (header.width + tileSize - 1) / tileSize;
+    const int tileCount = tileCountOf(header);
+
+    std::vector<uint64_t> offsets(tileCount + 1);
+    std::memcpy(&offsets[0], payload, offsets.size() * sizeof(uint64_t));
+    for (int t = 0; t < tileCount; t++)
+    {
+        if (offsets[t] > offsets[t + 1] || offsets[t + 1] > header.dataSize)
+        {
+            std::cerr << "SDFGridFile: Corrupt tile table" << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<unsigned char> tileValid(tileCount, 0);
+    ThreadPool::shared().parallelFor(tileCount, 0, [&](int t)
+    {
+        int x0 = (t % tilesX) * tileSize;
+        int y0 = (t / tilesX) * tileSize;
+        tileValid[t] = decodeTile(payload + offsets[t], payload + offsets[t + 1], data,
+                                  header.width, x0, y0,
+                                  std::min(tileSize, header.width - x0),
+                                  std::min(tileSize, header.height - y0)) ? 1 : 0;
+    });
+
+    for (int t = 0; t < tileCount; t++)
+    {
+        if (!tileValid[t])
+        {
+            std::cerr << "SDFGridFile: Corrupt tile " << t << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Header for a grid of the given layout, dataSize not set
+ */
+static void makeHeader(int width, int height, float minX, float maxX, float minY, float maxY,
+                       const SDFGridFileInfo& info, FileHeader& header)
+{
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.headerSize = sizeof(FileHeader);
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.valueType = static_cast<uint32_t>(SDFGridValueType::Float32);
+    header.width = width;
+    header.height = height;
+    header.minX = minX;
+    header.maxX = maxX;
+    header.minY = minY;
+    header.maxY = maxY;
+    header.compression = static_cast<uint32_t>(info.compression);
+    header.tileSize = info.compression == SDFGridCompression::Tiles ? std::max(info.tileSize, 1) : 0;
+    header.gridMethod = static_cast<uint32_t>(info.gridMethod);
+    header.gridSize = info.gridSize;
+    header.padding = info.padding;
+    header.maxDistance = info.maxDistance;
+    header.maxGridSize = info.maxGridSize;
+    header.polygonHash = info.polygonHash;
+    header.dataOffset = (sizeof(FileHeader) + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+std::shared_ptr<SDFGridSnapshot> SDFGridFile::makeSnapshot(int width, int height,
+                                                         float minX, float maxX,
+                                                         float minY, float maxY)
+{
+    std::shared_ptr<SDFGridSnapshot> grid(new SDFGridSnapshot());
+    grid->m_width = width;
+    grid->m_height = height;
+    grid->m_minX = minX;
+    grid->m_maxX = maxX;
+    grid->m_minY = minY;
+    grid->m_maxY = maxY;
+    return grid;
+}
+
+bool SDFGridFile::write(const std::string& path, const SDFGridSnapshot& grid,
+                        const SDFGridFileInfo& info)
+{
+    const float* data = grid.getData();
+    if (data == nullptr)
+    {
+        std::cerr << "SDFGridFile: Only dense float grids can be written" << std::endl;
+        return false;
+    }
+
+    float minX, maxX, minY, maxY;
+    grid.getBounds(minX, maxX, minY, maxY);
+    FileHeader header;
+    makeHeader(grid.getWidth(), grid.getHeight(), minX, maxX, minY, maxY, info, header);
+
+    const size_t sampleCount = static_cast<size_t>(header.width) * header.height;
+    std::vector<uint64_t> offsets;
+    std::vector<std::vector<unsigned char> > tiles;
+    if (info.compression == SDFGridCompression::Tiles)
+    {
+        const int tileSize = header.tileSize;
+        const int tilesX = (header.width + tileSize - 1) / tileSize;
+        const int tileCount = tileCountOf(header);
+
+        tiles.resize(tileCount);
+        ThreadPool::shared().parallelFor(tileCount, 0, [&](int t)
+        {
+            int x0 = (t % tilesX) * tileSize;
+            int y0 = (t / tilesX) * tileSize;
+            encodeTile(data, header.width, x0, y0,
+                       std::min(tileSize, header.width - x0),
+                       std::min(tileSize, header.height - y0), tiles[t]);
+        });
+
+        // Offsets are relative to the data offset, after the table itself
+        offsets.resize(tileCount + 1);
+        offsets[0] = offsets.size() * sizeof(uint64_t);
+        for (int t = 0; t < tileCount; t++)
+            offsets[t + 1] = offsets[t] + tiles[t].size();
+        header.dataSize = offsets.back();
+    }
+    else
+    {
+        header.dataSize = sampleCount * sizeof(float);
+    }
+
+    // Written next to the target and renamed over it, so a mapping of the
+    // old file (possibly the source of data) is never truncated under it
+    const std::string temporary = temporaryPath(path);
+    std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "SDFGridFile: Cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    static const char zeros[DATA_ALIGNMENT] = {};
+    file.write(zeros, static_cast<std::streamsize>(header.dataOffset - sizeof(header)));
+
+    if (info.compression == SDFGridCompression::Tiles)
+    {
+        file.write(reinterpret_cast<const char*>(&offsets[0]),
+                   static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            if (!tiles[t].empty())
+                file.write(reinterpret_cast<const char*>(&tiles[t][0]),
+                           static_cast<std::streamsize>(tiles[t].size()));
+        }
+    }
+    else
+    {
+        file.write(reinterpret_cast<const char*>(data),
+                   static_cast<std::streamsize>(sampleCount * sizeof(float)));
+    }
+
+    file.close();
+    if (!file)
+    {
+        std::remove(temporary.c_str());
+        std::cerr << "SDFGridFile: Failed to write " << path << std::endl;
+        return false;
+    }
+    return replacePath(temporary, path);
+}
+
+/**
+ * @brief Read and validate the header of an open file
+ */
+static bool readHeader(std::ifstream& file, const std::string& path, FileHeader& header)
+{
+    if (!file)
+    {
+        std::cerr << "SDFGridFile: Cannot open " << path << std::endl;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    if (fileSize < sizeof(FileHeader) ||
+        !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        std::cerr << "SDFGridFile: Not a grid file" << std::endl;
+        return false;
+    }
+    return validateHeader(header, fileSize);
+}
+
+uint64_t SDFGridFile::hashPolygon(const std::vector<Point2D>& polygon)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < polygon.size(); i++)
+    {
+        unsigned char bytes[2 * sizeof(float)];
+        std::memcpy(bytes, &polygon[i].x, sizeof(float));
+        std::memcpy(bytes + sizeof(float), &polygon[i].y, sizeof(float));
+        for (size_t k = 0; k < sizeof(bytes); k++)
+        {
+            hash ^= bytes[k];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool SDFGridFile::readInfo(const std::string& path, SDFGridFileInfo& info)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    FileHeader header;
+    if (!readHeader(file, path, header))
+        return false;
+
+    headerToInfo(header, info);
+    return true;
+}
+
+std::shared_ptr<const SDFGridSnapshot> SDFGridFile::load(const std::string& path,
+                                                         SDFGridFileInfo* info)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    FileHeader header;
+    if (!readHeader(file, path, header))
+        return std::shared_ptr<const SDFGridSnapshot>();
+
+    std::shared_ptr<SDFGridSnapshot> grid = makeSnapshot(
+        header.width, header.height, header.minX, header.maxX, header.minY, header.maxY);
+    grid->m_data.resize(static_cast<size_t>(header.width) * header.height);
+    grid->m_samples = &grid->m_data[0];
+
+    file.seekg(static_cast<std::streamoff>(header.dataOffset), std::ios::beg);
+    bool loaded;
+    if (header.compression == static_cast<uint32_t>(SDFGridCompression::None))
+    {
+        loaded = static_cast<bool>(file.read(reinterpret_cast<char*>(&grid->m_data[0]),
+                                             static_cast<std::streamsize>(header.dataSize)));
+    }
+    else
+    {
+        std::vector<unsigned char> payload(static_cast<size_t>(header.dataSize));
+        loaded = static_cast<bool>(file.read(reinterpret_cast<char*>(&payload[0]),
+                                             static_cast<std::streamsize>(payload.size()))) &&
+                 decodeTiles(header, &payload[0], &grid->m_data[0]);
+    }
+
+    if (!loaded)
+    {
+        std::cerr << "SDFGridFile: Failed to read " << path << std::endl;
+        return std::shared_ptr<const SDFGridSnapshot>();
+    }
+
+    if (info != nullptr)
+        headerToInfo(header, *info);
+    return grid;
+}
+
+std::shared_ptr<const SDFGridSnapshot> SDFGridFile::map(const std::string& path,
+                                                        SDFGridFileInfo* info)
+{
+    std::shared_ptr<FileMapping> mapping = std::make_shared<FileMapping>();
+
+#if defined(_WIN32)
+    mapping->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (mapping->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(mapping->file, &fileSize))
+    {
+        std::cerr << "SDFGridFile: Cannot open " << path << std::endl;
+        return std::shared_ptr<const SDFGridSnapshot>();
+    }
+    mapping->size = static_cast<size_t>(fileSize.QuadPart);
+    if (mapping->size >= sizeof(FileHeader))
+    {
+        mapping->mapping = CreateFileMappingA(mapping->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping->mapping != nullptr)
+            mapping->base = static_cast<const unsigned char*>(
+                MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        std::cerr << "SDFGridFile: Cannot open " << path << std::endl;
+        return std::shared_ptr<const SDFGridSnapshot>();
+    }
+    mapping->size = static_cast<size_t>(status.st_size);
+    if (mapping->size >= sizeof(FileHeader))
+    {
+        void* base = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED)
+            mapping->base = static_cast<const unsigned char*>(base);
+    }
+    close(fd);  // The mapping stays valid
+#endif
+
+    if (mapping->base == nullptr)
+    {
+        std::cerr << "SDFGridFile: Cannot map " << path << std::endl;
+        return std::shared_ptr<const SDFGridSnapshot>();
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping->base, sizeof(header));
+    if (!validateHeader(header, mapping->size))
+        return std::shared_ptr<const SDFGridSnapshot>();
+    if (header.compression != static_cast<uint32_t>(SDFGridCompression::None))
+    {
+        std::cerr << "SDFGridFile: Compressed grids cannot be mapped, use load()" << std::endl;
+        return std::shared_ptr<const SDFGridSnapshot>();
+    }
+
+    // The data offset is 64-byte aligned and the mapping page-aligned
+    std::shared_ptr<SDFGridSnapshot> grid = makeSnapshot(
+        header.width, header.height, header.minX, header.maxX, header.minY, header.maxY);
+    grid->m_samples = reinterpret_cast<const float*>(mapping->base + header.dataOffset);
+    grid->m_mapping = mapping;
+
+    if (info != nullptr)
+        headerToInfo(header, *info);
+    return grid;
+}
+
+SDFGridFileWriter::SDFGridFileWriter()
+    : m_width(0)
+    , m_height(0)
+    , m_rowsWritten(0)
+{
+}
+
+SDFGridFileWriter::~SDFGridFileWriter()
+{
+    discard();
+}
+
+void SDFGridFileWriter::discard()
+{
+    if (m_file.is_open())
+    {
+        m_file.close();
+        std::remove(m_temporaryPath.c_str());
+    }
+    m_file.clear();
+}
+
+bool SDFGridFileWriter::open(const std::string& path, int width, int height,
+                             float minX, float maxX, float minY, float maxY,
+                             const SDFGridFileInfo& info)
+{
+    discard();
+    m_width = m_height = m_rowsWritten = 0;
+    if (width < 2 || height < 2)
+    {
+        std::cerr << "SDFGridFileWriter: Invalid grid size" << std::endl;
+        return false;
+    }
+
+    // Rows are appended as they come, so the payload is never compressed
+    SDFGridFileInfo rawInfo = info;
+    rawInfo.compression = SDFGridCompression::None;
+
+    FileHeader header;
+    makeHeader(width, height, minX, maxX, minY, maxY, rawInfo, header);
+    header.dataSize = static_cast<uint64_t>(width) * height * sizeof(float);
+
+    // Replaces path only on a successful close()
+    m_path = path;
+    m_temporaryPath = temporaryPath(path);
+    m_file.open(m_temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        std::cerr << "SDFGridFileWriter: Cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    static const char zeros[DATA_ALIGNMENT] = {};
+    m_file.write(zeros, static_cast<std::streamsize>(header.dataOffset - sizeof(header)));
+
+    m_width = width;
+    m_height = height;
+    return static_cast<bool>(m_file);
+}
+
+bool SDFGridFileWriter::writeRows(int rowBegin, int rowCount, const float* rows)
+{
+    if (!m_file.is_open() || rows == nullptr || rowBegin != m_rowsWritten ||
+        rowCount < 0 || rowCount > m_height - m_rowsWritten)
+    {
+        std::cerr << "SDFGridFileWriter: Rows must be written once, in order" << std::endl;
+        return false;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(rows),
+                 static_cast<std::streamsize>(static_cast<size_t>(rowCount) * m_width * sizeof(float)));
+    m_rowsWritten += rowCount;
+    return static_cast<bool>(m_file);
+}
+
+bool SDFGridFileWriter::close()
+{
+    if (!m_file.is_open())
+        return false;
+
+    bool complete = m_rowsWritten == m_height;
+    m_file.close();
+    if (!complete || !m_file)
+    {
+        std::remove(m_temporaryPath.c_str());
+        std::cerr << "SDFGridFileWriter: Incomplete grid file" << std::endl;
+        return false;
+    }
+    return replacePath(m_temporaryPath, m_path);
+}
@@ -0,0 +1,513 @@
+#include "SDFGridSnapshot.h"
+#include "SDFStreaming.h"
+#include "sdf_simd.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+// Rows unpacked at a time when tracing a quantized grid
+static const int UNPACK_BLOCK_ROWS = 64;
+
+SDFGridSnapshot::SDFGridSnapshot()
+    : m_samples(nullptr)
+    , m_format(SDFValueFormat::Float32)
+    , m_codeScale(0.0f)
+    , m_codeOffset(0.0f)
+    , m_clampDistance(std::numeric_limits<float>::max())
+    , m_sparse(false)
+    , m_width(0)
+    , m_height(0)
+    , m_minX(0.0f)
+    , m_maxX(0.0f)
+    , m_minY(0.0f)
+    , m_maxY(0.0f)
+    , m_threadCount(0)
+{
+}
+
+void SDFGridSnapshot::getBounds(float& outMinX, float& outMaxX,
+                                float& outMinY, float& outMaxY) const
+{
+    outMinX = m_minX;
+    outMaxX = m_maxX;
+    outMinY = m_minY;
+    outMaxY = m_maxY;
+}
+
+size_t SDFGridSnapshot::getMemoryUsage() const
+{
+    if (m_sparse)
+        return m_sparseGrid.getMemoryUsage();
+    if (m_format == SDFValueFormat::UNorm8)
+        return m_codes8.size();
+    if (m_format == SDFValueFormat::UNorm16)
+        return m_codes16.size() * sizeof(unsigned short);
+    return static_cast<size_t>(m_width) * m_height * sizeof(float);
+}
+
+const void* SDFGridSnapshot::getCodes() const
+{
+    if (m_sparse || m_format == SDFValueFormat::Float32)
+        return nullptr;
+    if (m_format == SDFValueFormat::UNorm8)
+        return m_codes8.data();
+    return m_codes16.data();
+}
+
+void SDFGridSnapshot::getQuantization(float& outScale, float& outOffset) const
+{
+    outScale = m_codeScale;
+    outOffset = m_codeOffset;
+}
+
+void SDFGridSnapshot::unpackRows(int rowBegin, int rowCount, float* out) const
+{
+    if (m_sparse || out == nullptr || rowBegin < 0 || rowCount <= 0 || rowBegin + rowCount > m_height)
+        return;
+
+    const size_t first = static_cast<size_t>(rowBegin) * m_width;
+    const int count = rowCount * m_width;
+    switch (m_format)
+    {
+    case SDFValueFormat::UNorm8:
+        getSDFUnpack8Kernel()(m_codes8.data() + first, count, m_codeScale, m_codeOffset, out);
+        break;
+    case SDFValueFormat::UNorm16:
+        getSDFUnpack16Kernel()(m_codes16.data() + first, count, m_codeScale, m_codeOffset, out);
+        break;
+    default:
+        std::copy(m_samples + first, m_samples + first + count, out);
+        break;
+    }
+}
+
+float SDFGridSnapshot::denseValue(int x, int y) const
+{
+    const size_t index = static_cast<size_t>(y) * m_width + x;
+    switch (m_format)
+    {
+    case SDFValueFormat::UNorm8:
+        return static_cast<float>(m_codes8[index]) * m_codeScale + m_codeOffset;
+    case SDFValueFormat::UNorm16:
+        return static_cast<float>(m_codes16[index]) * m_codeScale + m_codeOffset;
+    default:
+        return m_samples[index];
+    }
+}
+
+float SDFGridSnapshot::sample(const Point2D& point) const
+{
+    if (m_sparse)
+        return m_sparseGrid.sample(point);
+    if (m_width < 1 || m_height < 1)
+        return 0.0f;
+
+    // Continuous sample coordinates, clamped to the sample area (same
+    // layout as SparseSDFGrid::sample())
+    const float stepX = (m_maxX - m_minX) / m_width;
+    const float stepY = (m_maxY - m_minY) / m_height;
+    float gx = clamp((point.x - m_minX) / stepX - 0.5f, 0.0f, static_cast<float>(m_width - 1));
+    float gy = clamp((point.y - m_minY) / stepY - 0.5f, 0.0f, static_cast<float>(m_height - 1));
+
+    int x0 = static_cast<int>(gx);
+    int y0 = static_cast<int>(gy);
+    int x1 = std::min(x0 + 1, m_width - 1);
+    int y1 = std::min(y0 + 1, m_height - 1);
+    float fx = gx - x0;
+    float fy = gy - y0;
+
+    float bottom = lerp(denseValue(x0, y0), denseValue(x1, y0), fx);
+    float top = lerp(denseValue(x0, y1), denseValue(x1, y1), fx);
+    return lerp(bottom, top, fy);
+}
+
+void SDFGridSnapshot::sample(const Point2D* points, size_t count, float* out) const
+{
+    if (points == nullptr || out == nullptr)
+        return;
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = sample(points[i]);
+}
+
+template <int Size>
+bool SDFGridSnapshot::gatherSamples(int x0, int y0, float* out) const
+{
+    if (!m_sparse && m_format == SDFValueFormat::Float32)
+    {
+        const float* row = m_samples + static_cast<size_t>(y0) * m_width + x0;
+        for (int j = 0; j < Size; j++, row += m_width)
+        {
+            for (int i = 0; i < Size; i++)
+                out[j * Size + i] = row[i];
+        }
+    }
+    else
+    {
+        for (int j = 0; j < Size; j++)
+        {
+            for (int i = 0; i < Size; i++)
+                out[j * Size + i] = gridValue(x0 + i, y0 + j);
+        }
+    }
+
+    // Nothing is clamped in Exact and DistanceTransform float grids
+    if (m_clampDistance == std::numeric_limits<float>::max())
+        return true;
+
+    float largest = 0.0f;
+    for (int k = 0; k < Size * Size; k++)
+        largest = std::max(largest, std::fabs(out[k]));
+    return largest < m_clampDistance;
+}
+
+/**
+ * @brief Catmull-Rom weights of samples -1, 0, 1, 2 at t in [0, 1], and their derivatives
+ */
+static void catmullRomWeights(float t, float weights[4], float derivatives[4])
+{
+    float t2 = t * t;
+    float t3 = t2 * t;
+    weights[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+    weights[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    weights[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    weights[3] = 0.5f * (t3 - t2);
+    derivatives[0] = 0.5f * (-3.0f * t2 + 4.0f * t - 1.0f);
+    derivatives[1] = 0.5f * (9.0f * t2 - 10.0f * t);
+    derivatives[2] = 0.5f * (-9.0f * t2 + 8.0f * t + 1.0f);
+    derivatives[3] = 0.5f * (3.0f * t2 - 2.0f * t);
+}
+
+bool SDFGridSnapshot::sample(const Point2D& point, SDFInterpolation interpolation,
+                             float& outValue, Point2D* outGradient) const
+{
+    // Samples needed on each side of the cell
+    const int margin = interpolation == SDFInterpolation::CatmullRom ? 1 : 0;
+    if (m_width < 2 + 2 * margin || m_height < 2 + 2 * margin)
+        return false;
+    if (m_sparse ? !m_sparseGrid.isValid() : (m_format == SDFValueFormat::Float32 && m_samples == nullptr))
+        return false;
+
+    const float stepX = (m_maxX - m_minX) / m_width;
+    const float stepY = (m_maxY - m_minY) / m_height;
+    float gx = (point.x - m_minX) / stepX - 0.5f;
+    float gy = (point.y - m_minY) / stepY - 0.5f;
+    if (!(gx >= margin && gx <= m_width - 1 - margin && gy >= margin && gy <= m_height - 1 - margin))
+        return false;
+
+    // Lower-left sample of the cell (the last cell for points on the far border)
+    int x0 = std::min(static_cast<int>(gx), m_width - 2 - margin);
+    int y0 = std::min(static_cast<int>(gy), m_height - 2 - margin);
+    float fx = gx - x0;
+    float fy = gy - y0;
+
+    float v[16];
+    if (interpolation == SDFInterpolation::Bilinear)
+    {
+        if (!gatherSamples<2>(x0, y0, v))
+            return false;
+
+        float bottom = lerp(v[0], v[1], fx);
+        float top = lerp(v[2], v[3], fx);
+        outValue = lerp(bottom, top, fy);
+        if (outGradient)
+        {
+            outGradient->x = lerp(v[1] - v[0], v[3] - v[2], fy) / stepX;
+            outGradient->y = (top - bottom) / stepY;
+        }
+        return true;
+    }
+
+    if (!gatherSamples<4>(x0 - 1, y0 - 1, v))
+        return false;
+
+    float wx[4], dwx[4], wy[4], dwy[4];
+    catmullRomWeights(fx, wx, dwx);
+    catmullRomWeights(fy, wy, dwy);
+
+    float value = 0.0f, dx = 0.0f, dy = 0.0f;
+    for (int j = 0; j < 4; j++)
+    {
+        const float* row = v + 4 * j;
+        float rowValue = wx[0] * row[0] + wx[1] * row[1] + wx[2] * row[2] + wx[3] * row[3];
+        float rowDx = dwx[0] * row[0] + dwx[1] * row[1] + dwx[2] * row[2] + dwx[3] * row[3];
+        value += wy[j] * rowValue;
+        dx += wy[j] * rowDx;
+        dy += dwy[j] * rowValue;
+    }
+
+    outValue = value;
+    if (outGradient)
+    {
+        outGradient->x = dx / stepX;
+        outGradient->y = dy / stepY;
+    }
+    return true;
+}
+
+std::vector<std::vector<IsoContour> > SDFGridSnapshot::traceQuantized(const std::vector<float>& levels) const
+{
+    std::vector<StreamingContourTracer> tracers;
+    tracers.reserve(levels.size());
+    for (size_t k = 0; k < levels.size(); k++)
+        tracers.push_back(StreamingContourTracer(m_width, m_height, m_minX, m_maxX, m_minY, m_maxY, levels[k]));
+
+    std::vector<float> rows(static_cast<size_t>(std::min(UNPACK_BLOCK_ROWS, m_height)) * m_width);
+    for (int rowBegin = 0; rowBegin < m_height; rowBegin += UNPACK_BLOCK_ROWS)
+    {
+        const int rowCount = std::min(UNPACK_BLOCK_ROWS, m_height - rowBegin);
+        unpackRows(rowBegin, rowCount, rows.data());
+        for (size_t k = 0; k < tracers.size(); k++)
+            tracers[k].addRows(rows.data(), rowCount);
+    }
+
+    std::vector<std::vector<IsoContour> > levelContours(levels.size());
+    for (size_t k = 0; k < tracers.size(); k++)
+        levelContours[k] = tracers[k].finish();
+    return levelContours;
+}
+
+/**
+ * @brief Build a ContourResult from traced contours (taken over)
+ */
+static ContourResult makeTracedResult(std::vector<IsoContour>& contours, float threshold)
+{
+    ContourResult result;
+    result.isValid = false;
+
+    for (size_t c = 0; c < contours.size(); c++)
+    {
+        const std::vector<Point2D>& points = contours[c].points;
+        size_t segmentCount = contours[c].closed ? points.size() : points.size() - 1;
+        for (size_t i = 0; i < segmentCount; i++)
+        {
+            result.lineSegments.push_back(points[i]);
+            result.lineSegments.push_back(points[(i + 1) % points.size()]);
+        }
+    }
+
+    if (result.lineSegments.size() < 4) // Need at least 2 line segments
+    {
+        std::cerr << "SDFGridSnapshot: No contour found at threshold " << threshold << std::endl;
+        return result;
+    }
+
+    // Same loop connectLineSegments() would return: the one through the
+    // first crossing cell
+    result.orderedPoints = contours[0].points;
+    result.contours.swap(contours);
+    result.isValid = result.orderedPoints.size() >= 3;
+    if (!result.isValid)
+    {
+        std::cerr << "SDFGridSnapshot: Failed to trace contour" << std::endl;
+    }
+    return result;
+}
+
+/**
+ * @brief Build a ContourResult from Marching Squares segments
+ */
+static ContourResult makeSegmentResult(const std::vector<Point2D>& segments, float threshold)
+{
+    ContourResult result;
+    result.isValid = false;
+
+    if (segments.size() < 4) // Need at least 2 line segments
+    {
+        std::cerr << "SDFGridSnapshot: No contour found at threshold " << threshold << std::endl;
+        return result;
+    }
+
+    // Connect line segments into ordered polylines; the first one is the
+    // loop through the first segment
+    result.contours = ::connectAllLineSegments(segments);
+    result.orderedPoints = result.contours.front().points;
+    result.lineSegments = segments;
+    result.isValid = result.orderedPoints.size() >= 3;
+
+    if (!result.isValid)
+    {
+        std::cerr << "SDFGridSnapshot: Failed to connect line segments" << std::endl;
+    }
+
+    return result;
+}
+
+void SDFGridSnapshot::copyOutputs(const ContourResult& source, ContourResult& out,
+                                  unsigned outputs)
+{
+    if (outputs & SDFContourPoints)
+        out.orderedPoints = source.orderedPoints;
+    else
+        out.orderedPoints.clear();
+
+    if (outputs & SDFContourSegments)
+        out.lineSegments = source.lineSegments;
+    else
+        out.lineSegments.clear();
+
+    if (outputs & SDFContourPolylines)
+        out.contours = source.contours;
+    else
+        out.contours.clear();
+
+    out.isValid = source.isValid;
+}
+
+ContourResult SDFGridSnapshot::extractContour(float threshold) const
+{
+    ContourResult result;
+    result.isValid = false;
+
+    if (m_width < 2 || m_height < 2)
+        return result;
+
+    if (!m_sparse && m_format != SDFValueFormat::Float32)
+    {
+        std::vector<std::vector<IsoContour> > levelContours =
+            traceQuantized(std::vector<float>(1, threshold));
+        return makeTracedResult(levelContours[0], threshold);
+    }
+
+    if (!m_sparse)
+    {
+        // Trace the contours directly: ordered, no segment matching
+        std::vector<IsoContour> contours = ::traceIsoContours(
+            m_samples, m_width, m_height,
+            m_minX, m_maxX, m_minY, m_maxY,
+            threshold, m_threadCount
+        );
+        return makeTracedResult(contours, threshold);
+    }
+
+    // Extract line segments using Marching Squares
+    return makeSegmentResult(m_sparseGrid.extractIsoContour(threshold, m_threadCount),
+                             threshold);
+}
+
+bool SDFGridSnapshot::extractContour(float threshold, ContourResult& out,
+                                     unsigned outputs) const
+{
+    copyOutputs(extractContour(threshold), out, outputs);
+    return out.isValid;
+}
+
+std::vector<ContourResult> SDFGridSnapshot::extractContours(const std::vector<float>& thresholds) const
+{
+    std::vector<ContourResult> results(thresholds.size());
+    for (size_t i = 0; i < results.size(); i++)
+        results[i].isValid = false;
+
+    if (m_width < 2 || m_height < 2)
+        return results;
+
+    if (m_sparse)
+    {
+        // Bricks are extracted per level
+        for (size_t i = 0; i < thresholds.size(); i++)
+            results[i] = extractContour(thresholds[i]);
+        return results;
+    }
+
+    // Levels in ascending order for the single sweep
+    std::vector<size_t> order(thresholds.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return thresholds[a] < thresholds[b];
+    });
+
+    std::vector<float> levels(order.size());
+    for (size_t k = 0; k < order.size(); k++)
+        levels[k] = thresholds[order[k]];
+
+    std::vector<std::vector<IsoContour> > levelContours;
+    if (m_format != SDFValueFormat::Float32)
+    {
+        levelContours = traceQuantized(levels);
+    }
+    else
+    {
+        levelContours = ::traceIsoContours(
+            m_samples, m_width, m_height,
+            m_minX, m_maxX, m_minY, m_maxY,
+            levels, m_threadCount
+        );
+    }
+
+    for (size_t k = 0; k < order.size(); k++)
+        results[order[k]] = makeTracedResult(levelContours[k], levels[k]);
+
+    return results;
+}
+
+RingResult SDFGridSnapshot::generateRing(float outerThreshold, float innerThreshold) const
+{
+    RingResult result;
+    generateRing(outerThreshold, innerThreshold, result);
+    return result;
+}
+
+bool SDFGridSnapshot::generateRing(float outerThreshold, float innerThreshold, RingResult& out,
+                                   unsigned outputs) const
+{
+    out.triangleVertices.clear();
+    out.triangleCount = 0;
+    out.outerContour.clear();
+    out.innerContour.clear();
+    out.isValid = false;
+
+    if (outerThreshold <= innerThreshold)
+    {
+        std::cerr << "SDFGridSnapshot: outerThreshold must be > innerThreshold" << std::endl;
+        return false;
+    }
+
+    // Extract both contours in one pass over the grid
+    std::vector<float> thresholds(2);
+    thresholds[0] = outerThreshold;
+    thresholds[1] = innerThreshold;
+    std::vector<ContourResult> contours = extractContours(thresholds);
+    if (!contours[0].isValid || !contours[1].isValid)
+    {
+        std::cerr << "SDFGridSnapshot: Failed to extract contours" << std::endl;
+        return false;
+    }
+
+    out.outerContour.swap(contours[0].orderedPoints);
+    out.innerContour.swap(contours[1].orderedPoints);
+
+    std::vector<Point2D> resampledOuter, resampledInner;
+    return triangulate(out, outputs, resampledOuter, resampledInner);
+}
+
+bool SDFGridSnapshot::triangulate(RingResult& out, unsigned outputs,
+                                  std::vector<Point2D>& resampledOuter,
+                                  std::vector<Point2D>& resampledInner)
+{
+    if (outputs & SDFRingTriangles)
+    {
+        // Triangulate the ring straight into the vertex array
+        out.triangleCount = ::triangulateRing(
+            out.outerContour, out.innerContour, out.triangleVertices,
+            resampledOuter, resampledInner
+        );
+
+        if (out.triangleCount == 0)
+        {
+            std::cerr << "SDFGridSnapshot: Triangulation failed" << std::endl;
+            return false;
+        }
+    }
+
+    if (!(outputs & SDFRingContours))
+    {
+        out.outerContour.clear();
+        out.innerContour.clear();
+    }
+
+    out.isValid = true;
+    return true;
+}
@@ -1,17 +1,34 @@
 #include "SDFProcessor.h"
+#include "SDFStreaming.h"
+#include "ThreadPool.h"
+#include "sdf_backends.h"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <utility>
+
+// Points per task of a batched sampleSDF() or querySDFGradients()
+static const size_t SAMPLE_BLOCK_POINTS = 4096;
+
+// Map values to the nearest code of value = code * scale - range, clamped
+template <typename Code>
+static void quantizeValues(const float* values, size_t count, float range, int maxCode, Code* out)
+{
+    float invScale = static_cast<float>(maxCode) / (2.0f * range);
+    for (size_t i = 0; i < count; ++i)
+    {
+        float v = std::max(-range, std::min(range, values[i]));
+        int code = static_cast<int>((v + range) * invScale + 0.5f);
+        out[i] = static_cast<Code>(std::min(code, maxCode));
+    }
+}
 
 SDFProcessor::SDFProcessor(const SDFConfig& config)
     : m_config(config)
-    , m_sdfData(nullptr)
-    , m_sdfWidth(0)
-    , m_sdfHeight(0)
-    , m_sdfMinX(0.0f)
-    , m_sdfMaxX(0.0f)
-    , m_sdfMinY(0.0f)
-    , m_sdfMaxY(0.0f)
     , m_sdfCacheValid(false)
+    , m_contourCacheHits(0)
+    , m_contourCacheMisses(0)
 {
 }
 
@@ -24,122 +41,690 @@ bool SDFProcessor::setPolygon(const std::vector<Point2D>& polygon)
     if (polygon.size() < 3)
     {
         m_polygon.clear();
+        m_prepared = PreparedPolygon();
+        m_edgeIndex.clear();
+        
+        // Nothing to generate: unpublish the old grid
+        std::atomic_store(&m_snapshot, std::shared_ptr<const SDFGridSnapshot>());
+        m_retired.reset();
+        m_mappedPath.clear();
         return false;
     }
     
     m_polygon = polygon;
+    ::preparePolygon(m_polygon, m_prepared);
+    m_edgeIndex.build(m_prepared);
     return true;
 }
 
+void SDFProcessor::setConfig(const SDFConfig& config)
+{
+    m_config = config;
+    clearSDFCache();
+}
+
 float SDFProcessor::querySDFValue(const Point2D& point) const
 {
     if (!isValid())
         return 0.0f;
     
-    // Direct calculation (no need for grid)
-    return ::calculatePolygonSDF(point, m_polygon);
+    // Direct calculation through the edge index (no need for grid)
+    return m_edgeIndex.signedDistance(point);
 }
 
-ContourResult SDFProcessor::extractContour(float threshold)
+void SDFProcessor::querySDFValues(const Point2D* points, size_t count, float* out) const
 {
-    ContourResult result;
-    result.isValid = false;
+    if (points == nullptr || out == nullptr || count == 0)
+        return;
     
     if (!isValid())
     {
-        std::cerr << "SDFProcessor: No valid polygon set" << std::endl;
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    
+    // Point2D is two packed floats: x and y advance by two floats per point
+    ::querySDFBatch(m_prepared, m_edgeIndex, &points[0].x, &points[0].y, 2,
+                    count, out, m_config.threadCount, m_config.useSIMD);
+}
+
+void SDFProcessor::querySDFValues(const float* xs, const float* ys, size_t count, float* out) const
+{
+    if (xs == nullptr || ys == nullptr || out == nullptr || count == 0)
+        return;
+    
+    if (!isValid())
+    {
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    
+    ::querySDFBatch(m_prepared, m_edgeIndex, xs, ys, 1,
+                    count, out, m_config.threadCount, m_config.useSIMD);
+}
+
+float SDFProcessor::querySDFGradient(const Point2D& point, Point2D& outGradient) const
+{
+    if (!isValid())
+    {
+        outGradient = Point2D();
+        return 0.0f;
+    }
+    
+    return m_edgeIndex.signedDistance(point, outGradient);
+}
+
+void SDFProcessor::querySDFGradients(const Point2D* points, size_t count,
+                                     float* outDistances, Point2D* outGradients) const
+{
+    if (points == nullptr || outDistances == nullptr || outGradients == nullptr || count == 0)
+        return;
+    
+    auto queryRange = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            outDistances[i] = querySDFGradient(points[i], outGradients[i]);
+    };
+    
+    int threads = ThreadPool::resolveThreadCount(m_config.threadCount);
+    if (threads <= 1 || count < 2 * SAMPLE_BLOCK_POINTS)
+    {
+        queryRange(0, count);
+        return;
+    }
+    
+    const int blockCount = static_cast<int>((count + SAMPLE_BLOCK_POINTS - 1) / SAMPLE_BLOCK_POINTS);
+    ThreadPool::shared().parallelFor(blockCount, threads, [&](int block)
+    {
+        size_t begin = static_cast<size_t>(block) * SAMPLE_BLOCK_POINTS;
+        queryRange(begin, std::min(count, begin + SAMPLE_BLOCK_POINTS));
+    });
+}
+
+bool SDFProcessor::generateSDFGradientGrid(float* sdfData, Point2D* gradientData) const
+{
+    if (!isValid() || sdfData == nullptr || gradientData == nullptr)
+        return false;
+    
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    ::generateSDFGradientGrid(width, height, minX, maxX, minY, maxY,
+                              m_prepared, sdfData, gradientData, getGridOptions());
+    return true;
+}
+
+bool SDFProcessor::generateSDFGradientGridInterleaved(float* data) const
+{
+    if (!isValid() || data == nullptr)
+        return false;
+    
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    ::generateSDFGradientGridInterleaved(width, height, minX, maxX, minY, maxY,
+                                         m_prepared, data, getGridOptions());
+    return true;
+}
+
+float SDFProcessor::sampleSDF(const Point2D& point, SDFInterpolation interpolation,
+                              Point2D* outGradient)
+{
+    float value = 0.0f;
+    sampleSDF(&point, 1, &value, interpolation, outGradient);
+    return value;
+}
+
+void SDFProcessor::sampleSDF(const Point2D* points, size_t count, float* out,
+                             SDFInterpolation interpolation, Point2D* outGradients)
+{
+    if (points == nullptr || out == nullptr || count == 0)
+        return;
+    
+    if (!isValid())
+    {
+        std::fill(out, out + count, 0.0f);
+        if (outGradients)
+            std::fill(outGradients, outGradients + count, Point2D());
+        return;
+    }
+    
+    // Without a grid every point takes the exact path
+    std::shared_ptr<const SDFGridSnapshot> grid;
+    if (ensureSDFGrid())
+        grid = m_snapshot;
+    
+    auto sampleRange = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            Point2D* gradient = outGradients ? &outGradients[i] : nullptr;
+            if (grid && grid->sample(points[i], interpolation, out[i], gradient))
+                continue;
+            
+            Point2D exactGradient;
+            out[i] = querySDFGradient(points[i], exactGradient);
+            if (gradient)
+                *gradient = exactGradient;
+        }
+    };
+    
+    int threads = ThreadPool::resolveThreadCount(m_config.threadCount);
+    if (threads <= 1 || count < 2 * SAMPLE_BLOCK_POINTS)
+    {
+        sampleRange(0, count);
+        return;
+    }
+    
+    const int blockCount = static_cast<int>((count + SAMPLE_BLOCK_POINTS - 1) / SAMPLE_BLOCK_POINTS);
+    ThreadPool::shared().parallelFor(blockCount, threads, [&](int block)
+    {
+        size_t begin = static_cast<size_t>(block) * SAMPLE_BLOCK_POINTS;
+        sampleRange(begin, std::min(count, begin + SAMPLE_BLOCK_POINTS));
+    });
+}
+
+/**
+ * @brief Copy some edges of a prepared polygon into a new one
+ */
+static void copyPreparedEdges(const PreparedPolygon& source, const int* edges, int count,
+                              PreparedPolygon& out)
+{
+    out = PreparedPolygon();
+    for (int k = 0; k < count; k++)
+    {
+        int i = edges[k];
+        out.originX.push_back(source.originX[i]);
+        out.originY.push_back(source.originY[i]);
+        out.dirX.push_back(source.dirX[i]);
+        out.dirY.push_back(source.dirY[i]);
+        out.invLengthSq.push_back(source.invLengthSq[i]);
+        out.minY.push_back(source.minY[i]);
+        out.maxY.push_back(source.maxY[i]);
+    }
+    out.edgeCount = count;
+}
+
+SDFUpdateResult SDFProcessor::moveVertex(int index, const Point2D& newPosition)
+{
+    SDFUpdateResult result;
+    result.changedSamples = 0;
+    result.fullRegeneration = false;
+    result.isValid = false;
+    
+    if (!isValid() || index < 0 || index >= static_cast<int>(m_polygon.size()))
+    {
+        std::cerr << "SDFProcessor: Invalid vertex index " << index << std::endl;
         return result;
     }
     
-    // Generate SDF grid if not cached
+    result.isValid = true;
+    const int n = static_cast<int>(m_polygon.size());
+    const Point2D oldPosition = m_polygon[index];
+    if (oldPosition.x == newPosition.x && oldPosition.y == newPosition.y)
+        return result;
+    
+    // Edge index ends at the vertex, edge index + 1 starts there
+    const int edges[2] = {index, (index + 1) % n};
+    PreparedPolygon oldEdges, newEdges;
+    copyPreparedEdges(m_prepared, edges, 2, oldEdges);
+    
+    m_polygon[index] = newPosition;
+    m_contourCache.clear();
+    ::preparePolygon(m_polygon, m_prepared);
+    m_edgeIndex.build(m_prepared);
+    copyPreparedEdges(m_prepared, edges, 2, newEdges);
+    
     if (!m_sdfCacheValid)
+        return result;  // Generated on demand with the new polygon
+    
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    
+    const std::shared_ptr<const SDFGridSnapshot> current = m_snapshot;
+    bool sameGrid = !current->m_sparse && current->m_format == SDFValueFormat::Float32 &&
+                    width == current->m_width && height == current->m_height &&
+                    minX == current->m_minX && maxX == current->m_maxX &&
+                    minY == current->m_minY && maxY == current->m_maxY;
+    
+    if (!sameGrid || m_config.storage != SDFStorage::Dense ||
+        m_config.valueFormat != SDFValueFormat::Float32 ||
+        m_config.gridMethod != SDFGridMethod::Exact)
     {
         generateSDFGrid();
-        if (!m_sdfCacheValid)
-        {
-            std::cerr << "SDFProcessor: Failed to generate SDF grid" << std::endl;
-            return result;
-        }
+        SDFTileRect all = {0, 0, m_snapshot->m_width, m_snapshot->m_height};
+        result.changedTiles.push_back(all);
+        result.changedSamples = all.width * all.height;
+        result.fullRegeneration = true;
+        return result;
     }
     
-    // Extract line segments using Marching Squares
-    std::vector<Point2D> segments = ::extractIsoContour(
-        m_sdfData, m_sdfWidth, m_sdfHeight,
-        m_sdfMinX, m_sdfMaxX, m_sdfMinY, m_sdfMaxY,
-        threshold
+    // Readers may hold the published grid: update a copy and publish that
+    std::shared_ptr<SDFGridSnapshot> grid = takeRetiredSnapshot();
+    grid->m_sparse = false;
+    grid->m_sparseGrid.clear();
+    grid->m_width = current->m_width;
+    grid->m_height = current->m_height;
+    grid->m_minX = current->m_minX;
+    grid->m_maxX = current->m_maxX;
+    grid->m_minY = current->m_minY;
+    grid->m_maxY = current->m_maxY;
+    grid->m_threadCount = m_config.threadCount;
+    grid->m_data.assign(current->m_samples,
+                        current->m_samples + static_cast<size_t>(grid->m_width) * grid->m_height);
+    grid->m_samples = &grid->m_data[0];
+    grid->m_mapping.reset();
+    grid->m_clampDistance = current->m_clampDistance;
+    grid->m_format = SDFValueFormat::Float32;
+    grid->m_codes8.clear();
+    grid->m_codes16.clear();
+    
+    // The region between the old and new edges, where signs can flip
+    const Point2D& previous = m_polygon[(index + n - 1) % n];
+    const Point2D& next = m_polygon[(index + 1) % n];
+    const Point2D sweptTriangles[6] = {
+        previous, oldPosition, newPosition,
+        next, oldPosition, newPosition
+    };
+    
+    const int tileSize = std::max(1, m_config.tileSize);
+    std::vector<unsigned char> changedTiles;
+    result.changedSamples = ::updateSDFGridEdges(
+        grid->m_width, grid->m_height,
+        grid->m_minX, grid->m_maxX, grid->m_minY, grid->m_maxY,
+        oldEdges, newEdges, sweptTriangles, 2,
+        m_edgeIndex, tileSize, &grid->m_data[0], changedTiles,
+        m_config.threadCount
     );
+    publishSnapshot(grid);
     
-    if (segments.size() < 4) // Need at least 2 line segments
+    const int tilesX = (grid->m_width + tileSize - 1) / tileSize;
+    for (size_t t = 0; t < changedTiles.size(); t++)
     {
-        std::cerr << "SDFProcessor: No contour found at threshold " << threshold << std::endl;
-        return result;
+        if (!changedTiles[t])
+            continue;
+        
+        SDFTileRect tile;
+        tile.x = static_cast<int>(t % tilesX) * tileSize;
+        tile.y = static_cast<int>(t / tilesX) * tileSize;
+        tile.width = std::min(tileSize, grid->m_width - tile.x);
+        tile.height = std::min(tileSize, grid->m_height - tile.y);
+        result.changedTiles.push_back(tile);
+    }
+    
+    return result;
+}
+
+const float* SDFProcessor::getSDFGrid(int& outWidth, int& outHeight)
+{
+    outWidth = outHeight = 0;
+    if (!isValid() || m_config.storage != SDFStorage::Dense)
+        return nullptr;
+    
+    if (!ensureSDFGrid())
+        return nullptr;
+    
+    outWidth = m_snapshot->m_width;
+    outHeight = m_snapshot->m_height;
+    return m_snapshot->getData();
+}
+
+std::shared_ptr<const SDFGridSnapshot> SDFProcessor::getGridSnapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+std::shared_ptr<const SDFGridSnapshot> SDFProcessor::updateGridSnapshot()
+{
+    if (!isValid() || !ensureSDFGrid())
+        return std::shared_ptr<const SDFGridSnapshot>();
+    return m_snapshot;
+}
+
+bool SDFProcessor::saveGrid(const std::string& path, SDFGridCompression compression, int tileSize)
+{
+    if (!isValid() || m_config.storage != SDFStorage::Dense ||
+        m_config.valueFormat != SDFValueFormat::Float32)
+    {
+        std::cerr << "SDFProcessor: Only dense float grids can be saved" << std::endl;
+        return false;
+    }
+    
+    if (!ensureSDFGrid())
+        return false;
+    
+    if (!m_mappedPath.empty() && path == m_mappedPath)
+    {
+        std::cerr << "SDFProcessor: The grid is mapped from " << path
+                  << ", which already holds it" << std::endl;
+        return false;
+    }
+    
+    SDFGridFileInfo info = getGridFileInfo();
+    info.compression = compression;
+    info.tileSize = tileSize;
+    return SDFGridFile::write(path, *m_snapshot, info);
+}
+
+bool SDFProcessor::loadGrid(const std::string& path, bool mapFile)
+{
+    if (!isValid() || m_config.storage != SDFStorage::Dense ||
+        m_config.valueFormat != SDFValueFormat::Float32)
+    {
+        std::cerr << "SDFProcessor: Grids can only be loaded for a polygon with Dense float storage" << std::endl;
+        return false;
     }
     
-    // Connect line segments into ordered contour
-    result.orderedPoints = ::connectLineSegments(segments);
-    result.lineSegments = segments;
-    result.isValid = result.orderedPoints.size() >= 3;
+    SDFGridFileInfo info;
+    if (!SDFGridFile::readInfo(path, info))
+        return false;
+    if (info.version < 2)
+    {
+        std::cerr << "SDFProcessor: Grid file " << path
+                  << " has no polygon hash (version 1), save it again" << std::endl;
+        return false;
+    }
+    
+    // The extent only depends on the polygon's bounds, so the polygon itself
+    // is compared through its hash
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    bool matches = info.polygonHash == SDFGridFile::hashPolygon(m_polygon) &&
+                   info.width == width && info.height == height &&
+                   info.minX == minX && info.maxX == maxX &&
+                   info.minY == minY && info.maxY == maxY &&
+                   info.gridMethod == m_config.gridMethod;
+    if (m_config.gridMethod == SDFGridMethod::CharacteristicScan)
+        matches = matches && info.maxDistance == m_config.maxDistance;
+    if (!matches)
+    {
+        std::cerr << "SDFProcessor: Grid file does not match the polygon and config" << std::endl;
+        return false;
+    }
+    
+    std::shared_ptr<const SDFGridSnapshot> grid;
+    if (mapFile && info.compression == SDFGridCompression::None)
+        grid = SDFGridFile::map(path);
+    else
+        grid = SDFGridFile::load(path);
+    if (!grid)
+        return false;
+    
+    // Not published yet, so still private to this thread
+    std::shared_ptr<SDFGridSnapshot> loaded = std::const_pointer_cast<SDFGridSnapshot>(grid);
+    loaded->m_clampDistance = getClampDistance();
+    
+    clearSDFCache();
+    publishSnapshot(loaded);
+    if (loaded->isMapped())
+        m_mappedPath = path;
+    m_sdfCacheValid = true;
+    return true;
+}
+
+bool SDFProcessor::getGridExtent(int& outWidth, int& outHeight,
+                                 float& outMinX, float& outMaxX,
+                                 float& outMinY, float& outMaxY) const
+{
+    if (!isValid())
+    {
+        outWidth = outHeight = 0;
+        outMinX = outMaxX = outMinY = outMaxY = 0.0f;
+        return false;
+    }
+    
+    computeGridExtent(outMinX, outMaxX, outMinY, outMaxY, outWidth, outHeight);
+    return true;
+}
+
+bool SDFProcessor::streamSDFGrid(const SDFStripeSink& sink, int stripeRows) const
+{
+    if (!isValid())
+        return false;
+    
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    return ::generateSDFGridStripes(width, height, minX, maxX, minY, maxY,
+                                    m_prepared, stripeRows, sink, getGridOptions());
+}
+
+bool SDFProcessor::streamSDFGridToFile(const std::string& path, int stripeRows) const
+{
+    if (!isValid())
+        return false;
+    
+    float minX, maxX, minY, maxY;
+    int width, height;
+    computeGridExtent(minX, maxX, minY, maxY, width, height);
+    
+    SDFGridFileWriter writer;
+    if (!writer.open(path, width, height, minX, maxX, minY, maxY, getGridFileInfo()))
+        return false;
     
-    if (!result.isValid)
+    bool written = ::generateSDFGridStripes(
+        width, height, minX, maxX, minY, maxY, m_prepared, stripeRows,
+        [&writer](int rowBegin, int rowCount, const float* rows)
+        {
+            return writer.writeRows(rowBegin, rowCount, rows);
+        },
+        getGridOptions()
+    );
+    return writer.close() && written;
+}
+
+void SDFProcessor::getSDFGridBounds(float& outMinX, float& outMaxX,
+                                    float& outMinY, float& outMaxY) const
+{
+    if (!m_snapshot)
     {
-        std::cerr << "SDFProcessor: Failed to connect line segments" << std::endl;
+        outMinX = outMaxX = outMinY = outMaxY = 0.0f;
+        return;
     }
     
+    m_snapshot->getBounds(outMinX, outMaxX, outMinY, outMaxY);
+}
+
+ContourResult SDFProcessor::extractContour(float threshold)
+{
+    ContourResult result;
+    extractContour(threshold, result);
     return result;
 }
 
-RingResult SDFProcessor::generateRing(float outerThreshold, float innerThreshold)
+bool SDFProcessor::extractContour(float threshold, ContourResult& out, unsigned outputs)
 {
-    RingResult result;
-    result.triangleCount = 0;
-    result.isValid = false;
+    out.isValid = false;
     
     if (!isValid())
     {
         std::cerr << "SDFProcessor: No valid polygon set" << std::endl;
-        return result;
+        return false;
     }
     
-    if (outerThreshold <= innerThreshold)
+    const ContourResult* cached = findCachedContour(threshold);
+    if (cached != nullptr)
     {
-        std::cerr << "SDFProcessor: outerThreshold must be > innerThreshold" << std::endl;
-        return result;
+        SDFGridSnapshot::copyOutputs(*cached, out, outputs);
+        return out.isValid;
     }
     
-    // Extract both contours
-    ContourResult outerContour = extractContour(outerThreshold);
-    ContourResult innerContour = extractContour(innerThreshold);
+    if (!ensureSDFGrid())
+        return false;
+    
+    ContourResult result = m_snapshot->extractContour(threshold);
+    SDFGridSnapshot::copyOutputs(result, out, outputs);
+    if (result.isValid)
+        cacheContour(threshold, result);
+    return out.isValid;
+}
+
+std::vector<ContourResult> SDFProcessor::extractContours(const std::vector<float>& thresholds)
+{
+    std::vector<ContourResult> results(thresholds.size());
+    for (size_t i = 0; i < results.size(); i++)
+        results[i].isValid = false;
     
-    if (!outerContour.isValid || !innerContour.isValid)
+    if (!isValid())
     {
-        std::cerr << "SDFProcessor: Failed to extract contours" << std::endl;
-        return result;
+        std::cerr << "SDFProcessor: No valid polygon set" << std::endl;
+        return results;
     }
     
-    // Store contours
-    result.outerContour = outerContour.orderedPoints;
-    result.innerContour = innerContour.orderedPoints;
+    // Only the thresholds not in the cache are extracted
+    std::vector<size_t> missing;
+    std::vector<float> missingThresholds;
+    for (size_t i = 0; i < thresholds.size(); i++)
+    {
+        const ContourResult* cached = findCachedContour(thresholds[i]);
+        if (cached != nullptr)
+        {
+            results[i] = *cached;
+        }
+        else
+        {
+            missing.push_back(i);
+            missingThresholds.push_back(thresholds[i]);
+        }
+    }
+    if (missing.empty())
+        return results;
     
-    // Triangulate the ring
-    std::vector<Triangle> triangles = ::triangulateRing(
-        result.outerContour,
-        result.innerContour
-    );
+    std::vector<ContourResult> extracted;
+    if (!computeContours(missingThresholds, extracted))
+        return results;
     
-    if (triangles.empty())
+    for (size_t k = 0; k < missing.size(); k++)
     {
-        std::cerr << "SDFProcessor: Triangulation failed" << std::endl;
-        return result;
+        std::swap(results[missing[k]], extracted[k]);
+        if (results[missing[k]].isValid)
+            cacheContour(thresholds[missing[k]], results[missing[k]]);
     }
     
-    // Convert to vertex array
-    result.triangleVertices = ::trianglesToVertices(triangles);
-    result.triangleCount = static_cast<int>(triangles.size());
-    result.isValid = true;
+    return results;
+}
+
+bool SDFProcessor::computeContours(const std::vector<float>& thresholds,
+                                   std::vector<ContourResult>& results)
+{
+    if (!ensureSDFGrid())
+    {
+        results.assign(thresholds.size(), ContourResult());
+        for (size_t i = 0; i < results.size(); i++)
+            results[i].isValid = false;
+        return false;
+    }
     
+    results = m_snapshot->extractContours(thresholds);
+    return true;
+}
+
+const ContourResult* SDFProcessor::findCachedContour(float threshold)
+{
+    for (std::list<CachedContour>::iterator it = m_contourCache.begin();
+         it != m_contourCache.end(); ++it)
+    {
+        if (it->threshold == threshold)
+        {
+            // Most recently used first
+            m_contourCache.splice(m_contourCache.begin(), m_contourCache, it);
+            m_contourCacheHits++;
+            return &it->result;
+        }
+    }
+    
+    m_contourCacheMisses++;
+    return nullptr;
+}
+
+void SDFProcessor::cacheContour(float threshold, const ContourResult& result)
+{
+    if (m_config.contourCacheSize <= 0)
+        return;
+    
+    CachedContour entry;
+    entry.threshold = threshold;
+    entry.result = result;
+    m_contourCache.push_front(entry);
+    
+    while (m_contourCache.size() > static_cast<size_t>(m_config.contourCacheSize))
+        m_contourCache.pop_back();  // Least recently used
+}
+
+RingResult SDFProcessor::generateRing(float outerThreshold, float innerThreshold)
+{
+    RingResult result;
+    generateRing(outerThreshold, innerThreshold, result);
     return result;
 }
 
+bool SDFProcessor::generateRing(float outerThreshold, float innerThreshold, RingResult& out,
+                                unsigned outputs)
+{
+    out.triangleVertices.clear();
+    out.triangleCount = 0;
+    out.outerContour.clear();
+    out.innerContour.clear();
+    out.isValid = false;
+    
+    if (!isValid())
+    {
+        std::cerr << "SDFProcessor: No valid polygon set" << std::endl;
+        return false;
+    }
+    
+    if (outerThreshold <= innerThreshold)
+    {
+        std::cerr << "SDFProcessor: outerThreshold must be > innerThreshold" << std::endl;
+        return false;
+    }
+    
+    // Contour points are copied out of the cache right away: caching a
+    // newly extracted contour can evict the other one
+    const ContourResult* outerCached = findCachedContour(outerThreshold);
+    if (outerCached != nullptr)
+        out.outerContour = outerCached->orderedPoints;
+    const ContourResult* innerCached = findCachedContour(innerThreshold);
+    if (innerCached != nullptr)
+        out.innerContour = innerCached->orderedPoints;
+    
+    if (outerCached == nullptr || innerCached == nullptr)
+    {
+        // Extract the missing contours in one pass over the grid
+        std::vector<float> thresholds;
+        if (outerCached == nullptr)
+            thresholds.push_back(outerThreshold);
+        if (innerCached == nullptr)
+            thresholds.push_back(innerThreshold);
+        
+        std::vector<ContourResult> extracted;
+        bool extractedValid = computeContours(thresholds, extracted);
+        for (size_t k = 0; extractedValid && k < extracted.size(); k++)
+            extractedValid = extracted[k].isValid;
+        if (!extractedValid)
+        {
+            std::cerr << "SDFProcessor: Failed to extract contours" << std::endl;
+            return false;
+        }
+        
+        size_t k = 0;
+        if (outerCached == nullptr)
+        {
+            out.outerContour = extracted[k].orderedPoints;
+            cacheContour(outerThreshold, extracted[k++]);
+        }
+        if (innerCached == nullptr)
+        {
+            out.innerContour = extracted[k].orderedPoints;
+            cacheContour(innerThreshold, extracted[k]);
+        }
+    }
+    
+    return SDFGridSnapshot::triangulate(out, outputs, m_resampledOuter, m_resampledInner);
+}
+
 void SDFProcessor::getBounds(float& outMinX, float& outMaxX, 
                              float& outMinY, float& outMaxY) const
 {
@@ -159,48 +744,224 @@ void SDFProcessor::generateSDFGrid()
     if (!isValid())
         return;
     
-    // Calculate bounds with padding
-    float minX, maxX, minY, maxY;
-    ::calculatePolygonBounds(m_polygon, minX, maxX, minY, maxY);
+    std::shared_ptr<SDFGridSnapshot> grid = takeRetiredSnapshot();
+    computeGridExtent(grid->m_minX, grid->m_maxX, grid->m_minY, grid->m_maxY,
+                      grid->m_width, grid->m_height);
+    grid->m_threadCount = m_config.threadCount;
+    grid->m_clampDistance = getClampDistance();
     
-    m_sdfMinX = minX - m_config.padding;
-    m_sdfMaxX = maxX + m_config.padding;
-    m_sdfMinY = minY - m_config.padding;
-    m_sdfMaxY = maxY + m_config.padding;
+    if (m_config.storage == SDFStorage::Sparse)
+    {
+        grid->m_sparse = true;
+        std::vector<float>().swap(grid->m_data);
+        grid->m_samples = nullptr;
+        grid->m_mapping.reset();
+        grid->m_format = SDFValueFormat::Float32;
+        std::vector<unsigned char>().swap(grid->m_codes8);
+        std::vector<unsigned short>().swap(grid->m_codes16);
+        bool generated = grid->m_sparseGrid.generate(
+            grid->m_width, grid->m_height,
+            grid->m_minX, grid->m_maxX, grid->m_minY, grid->m_maxY,
+            m_prepared, m_config.maxDistance, m_config.brickSize,
+            m_config.threadCount
+        );
+        if (!generated)
+            return;
+    }
+    else if (m_config.valueFormat != SDFValueFormat::Float32)
+    {
+        if (!generateQuantizedGrid(*grid))
+            return;
+    }
+    else
+    {
+        grid->m_sparse = false;
+        grid->m_sparseGrid.clear();
+        grid->m_format = SDFValueFormat::Float32;
+        std::vector<unsigned char>().swap(grid->m_codes8);
+        std::vector<unsigned short>().swap(grid->m_codes16);
+        
+        // A reused snapshot keeps its allocation when the size fits
+        grid->m_data.resize(static_cast<size_t>(grid->m_width) * grid->m_height);
+        grid->m_samples = &grid->m_data[0];
+        grid->m_mapping.reset();
+        
+        // Call global function from sdf.h (not the member function)
+        ::generateSDFGrid(
+            grid->m_width, grid->m_height,
+            grid->m_minX, grid->m_maxX, grid->m_minY, grid->m_maxY,
+            m_prepared, &grid->m_data[0], getGridOptions()
+        );
+    }
     
-    // Calculate grid dimensions
-    float rangeX = m_sdfMaxX - m_sdfMinX;
-    float rangeY = m_sdfMaxY - m_sdfMinY;
+    publishSnapshot(grid);
+    m_sdfCacheValid = true;
+}
+
+bool SDFProcessor::generateQuantizedGrid(SDFGridSnapshot& grid) const
+{
+    float range = m_config.quantizeRange > 0.0f ? m_config.quantizeRange : m_config.maxDistance;
+    if (!(range > 0.0f))
+    {
+        std::cerr << "SDFProcessor: Quantized grids need a positive quantizeRange or maxDistance" << std::endl;
+        return false;
+    }
     
-    m_sdfWidth = static_cast<int>(rangeX / m_config.gridSize) + 1;
-    m_sdfHeight = static_cast<int>(rangeY / m_config.gridSize) + 1;
+    bool wide = m_config.valueFormat == SDFValueFormat::UNorm16;
+    int maxCode = wide ? 65535 : 255;
+    size_t count = static_cast<size_t>(grid.m_width) * grid.m_height;
     
-    // Limit grid size
-    m_sdfWidth = std::min(m_sdfWidth, m_config.maxGridSize);
-    m_sdfHeight = std::min(m_sdfHeight, m_config.maxGridSize);
+    grid.m_sparse = false;
+    grid.m_sparseGrid.clear();
+    std::vector<float>().swap(grid.m_data);
+    grid.m_samples = nullptr;
+    grid.m_mapping.reset();
+    grid.m_format = m_config.valueFormat;
+    grid.m_codeScale = 2.0f * range / static_cast<float>(maxCode);
+    grid.m_codeOffset = -range;
     
-    // Allocate and generate SDF data
-    m_sdfData = new float[m_sdfWidth * m_sdfHeight];
+    // Samples within a step of the range may have been clamped to it
+    grid.m_clampDistance = std::min(grid.m_clampDistance, range - grid.m_codeScale);
+    if (wide)
+    {
+        std::vector<unsigned char>().swap(grid.m_codes8);
+        grid.m_codes16.resize(count);
+    }
+    else
+    {
+        std::vector<unsigned short>().swap(grid.m_codes16);
+        grid.m_codes8.resize(count);
+    }
     
-    // Call global function from sdf.h (not the member function)
-    ::generateSDFGrid(
-        m_sdfWidth, m_sdfHeight,
-        m_sdfMinX, m_sdfMaxX, m_sdfMinY, m_sdfMaxY,
-        m_polygon, m_sdfData
-    );
+    if (m_config.gridMethod == SDFGridMethod::DistanceTransform)
+    {
+        // The transform passes need the whole grid: quantize it afterwards
+        std::vector<float> values(count);
+        ::generateSDFGrid(grid.m_width, grid.m_height,
+                          grid.m_minX, grid.m_maxX, grid.m_minY, grid.m_maxY,
+                          m_prepared, &values[0], getGridOptions());
+        if (wide)
+            quantizeValues(&values[0], count, range, maxCode, &grid.m_codes16[0]);
+        else
+            quantizeValues(&values[0], count, range, maxCode, &grid.m_codes8[0]);
+        return true;
+    }
     
-    m_sdfCacheValid = true;
+    // Otherwise only one stripe of floats exists at a time
+    int width = grid.m_width;
+    return ::generateSDFGridStripes(
+        grid.m_width, grid.m_height,
+        grid.m_minX, grid.m_maxX, grid.m_minY, grid.m_maxY,
+        m_prepared, 256,
+        [&](int rowBegin, int rowCount, const float* rows) {
+            size_t first = static_cast<size_t>(rowBegin) * width;
+            size_t rowValues = static_cast<size_t>(rowCount) * width;
+            if (wide)
+                quantizeValues(rows, rowValues, range, maxCode, &grid.m_codes16[first]);
+            else
+                quantizeValues(rows, rowValues, range, maxCode, &grid.m_codes8[first]);
+            return true;
+        },
+        getGridOptions());
 }
 
-void SDFProcessor::clearSDFCache()
+bool SDFProcessor::ensureSDFGrid()
+{
+    if (!m_sdfCacheValid)
+    {
+        generateSDFGrid();
+        if (!m_sdfCacheValid)
+        {
+            std::cerr << "SDFProcessor: Failed to generate SDF grid" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+SDFGridOptions SDFProcessor::getGridOptions() const
+{
+    SDFGridOptions options;
+    options.threadCount = m_config.threadCount;
+    options.useSIMD = m_config.useSIMD;
+    options.method = m_config.gridMethod;
+    options.maxDistance = m_config.maxDistance;
+    return options;
+}
+
+float SDFProcessor::getClampDistance() const
 {
-    if (m_sdfData != nullptr)
+    if (m_config.storage == SDFStorage::Sparse ||
+        (m_config.gridMethod == SDFGridMethod::CharacteristicScan && m_config.maxDistance > 0.0f))
     {
-        delete[] m_sdfData;
-        m_sdfData = nullptr;
+        return m_config.maxDistance;
+    }
+    return std::numeric_limits<float>::max();
+}
+
+SDFGridFileInfo SDFProcessor::getGridFileInfo() const
+{
+    SDFGridFileInfo info;
+    info.gridMethod = m_config.gridMethod;
+    info.gridSize = m_config.gridSize;
+    info.padding = m_config.padding;
+    info.maxDistance = m_config.maxDistance;
+    info.maxGridSize = m_config.maxGridSize;
+    info.polygonHash = SDFGridFile::hashPolygon(m_polygon);
+    return info;
+}
+
+std::shared_ptr<SDFGridSnapshot> SDFProcessor::takeRetiredSnapshot()
+{
+    // The retired grid is no longer published, so once no reader holds it
+    // nobody can pick it up again and its storage can be reused
+    std::shared_ptr<const SDFGridSnapshot> retired;
+    retired.swap(m_retired);
+    if (retired && retired.use_count() == 1)
+    {
+        // Pairs with the release of the last reader's reference
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        // Every snapshot is created non-const (here or by SDFGridFile)
+        return std::const_pointer_cast<SDFGridSnapshot>(retired);
     }
     
-    m_sdfWidth = 0;
-    m_sdfHeight = 0;
+    return std::shared_ptr<SDFGridSnapshot>(new SDFGridSnapshot());
+}
+
+void SDFProcessor::publishSnapshot(const std::shared_ptr<SDFGridSnapshot>& snapshot)
+{
+    std::shared_ptr<const SDFGridSnapshot> published = snapshot;
+    m_retired = std::atomic_exchange(&m_snapshot, published);
+    m_mappedPath.clear();
+}
+
+void SDFProcessor::computeGridExtent(float& minX, float& maxX, float& minY, float& maxY,
+                                     int& width, int& height) const
+{
+    // Calculate bounds with padding
+    ::calculatePolygonBounds(m_polygon, minX, maxX, minY, maxY);
+    
+    minX -= m_config.padding;
+    maxX += m_config.padding;
+    minY -= m_config.padding;
+    maxY += m_config.padding;
+    
+    // Calculate grid dimensions
+    float rangeX = maxX - minX;
+    float rangeY = maxY - minY;
+    
+    width = static_cast<int>(rangeX / m_config.gridSize) + 1;
+    height = static_cast<int>(rangeY / m_config.gridSize) + 1;
+    
+    // Limit grid size
+    width = std::min(width, m_config.maxGridSize);
+    height = std::min(height, m_config.maxGridSize);
+}
+
+void SDFProcessor::clearSDFCache()
+{
+    // The published grid stays readable until a new one replaces it
+    m_contourCache.clear();
     m_sdfCacheValid = false;
 }
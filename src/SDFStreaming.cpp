@@ -0,0 +1,402 @@
+#include "SDFStreaming.h"
+#include "sdf_backends.h"
+#include "sdf_simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+
+bool generateSDFGridStripes(int width, int height,
+                            float worldMinX, float worldMaxX,
+                            float worldMinY, float worldMaxY,
+                            const PreparedPolygon& prepared,
+                            int stripeRows,
+                            const SDFStripeSink& sink,
+                            const SDFGridOptions& options)
+{
+    if (width <= 0 || height <= 0 || stripeRows <= 0 || !sink)
+        return false;
+
+    const float stepX = (worldMaxX - worldMinX) / width;
+    const float stepY = (worldMaxY - worldMinY) / height;
+    const bool validSteps = stepX > 0.0f && stepY > 0.0f;
+    const int threads = ThreadPool::resolveThreadCount(options.threadCount);
+    stripeRows = std::min(stripeRows, height);
+
+    // Invalid polygon: every sample is "far outside", as in generateSDFGrid()
+    if (prepared.edgeCount < 3)
+    {
+        std::vector<float> stripe(static_cast<size_t>(stripeRows) * width,
+                                  std::numeric_limits<float>::max());
+        for (int rowBegin = 0; rowBegin < height; rowBegin += stripeRows)
+        {
+            if (!sink(rowBegin, std::min(stripeRows, height - rowBegin), stripe.data()))
+                return false;
+        }
+        return true;
+    }
+
+    // Rows are filled in bands, several per thread as in generateSDFGrid();
+    // stripes hold a whole number of bands
+    const int rowsPerBand = std::max(1, stripeRows / (threads * 4));
+    stripeRows = std::max(rowsPerBand, stripeRows / rowsPerBand * rowsPerBand);
+
+    const bool useCSC = options.method == SDFGridMethod::CharacteristicScan &&
+                        options.maxDistance > 0.0f && validSteps;
+    std::unique_ptr<CharacteristicBands> bands;
+    if (useCSC)
+    {
+        bands.reset(new CharacteristicBands(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                                            prepared, options.maxDistance, rowsPerBand));
+    }
+
+    // Signs row by row from the scanline pass (the whole-grid mask of
+    // generateSDFGrid() is what does not fit)
+    std::unique_ptr<ScanlineRows> scanline;
+    if (validSteps && (useCSC || options.useScanlineSign))
+    {
+        scanline.reset(new ScanlineRows(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                                        prepared));
+    }
+
+    SDFRowKernel rowKernel = options.useSIMD ? getSDFRowKernel() : computeSDFRowScalar;
+    std::vector<float> stripe(static_cast<size_t>(stripeRows) * width);
+
+    for (int rowBegin = 0; rowBegin < height; rowBegin += stripeRows)
+    {
+        const int rowCount = std::min(stripeRows, height - rowBegin);
+        const int firstBand = rowBegin / rowsPerBand;
+        const int bandCount = (rowCount + rowsPerBand - 1) / rowsPerBand;
+
+        ThreadPool::shared().parallelFor(bandCount, threads, [&](int k)
+        {
+            const int bandBegin = (firstBand + k) * rowsPerBand;
+            const int bandEnd = std::min(height, bandBegin + rowsPerBand);
+            float* rows = stripe.data() + static_cast<size_t>(bandBegin - rowBegin) * width;
+
+            std::vector<unsigned char> inside;
+            std::vector<int> delta;
+            if (scanline)
+                inside.resize(width);
+
+            if (useCSC)
+                bands->fillBand(firstBand + k, rows);
+
+            for (int y = bandBegin; y < bandEnd; y++)
+            {
+                float* row = rows + static_cast<size_t>(y - bandBegin) * width;
+                if (scanline)
+                    scanline->classifyRow(y, delta, inside.data());
+
+                if (useCSC)
+                {
+                    // Apply the sign
+                    for (int x = 0; x < width; x++)
+                    {
+                        if (inside[x])
+                            row[x] = -row[x];
+                    }
+                }
+                else
+                {
+                    rowKernel(prepared, worldMinX, stepX, worldMinY + (y + 0.5f) * stepY,
+                              width, row, scanline ? inside.data() : nullptr);
+                }
+            }
+        });
+
+        if (!sink(rowBegin, rowCount, stripe.data()))
+            return false;
+    }
+
+    return true;
+}
+
+StreamingContourTracer::StreamingContourTracer(int width, int height,
+                                               float worldMinX, float worldMaxX,
+                                               float worldMinY, float worldMaxY,
+                                               float isoValue)
+    : m_width(width)
+    , m_height(height)
+    , m_minX(worldMinX)
+    , m_minY(worldMinY)
+    , m_cellWidth(width > 1 ? (worldMaxX - worldMinX) / (width - 1) : 0.0f)
+    , m_cellHeight(height > 1 ? (worldMaxY - worldMinY) / (height - 1) : 0.0f)
+    , m_isoValue(isoValue)
+    , m_rowCount(0)
+{
+    if (width < 2 || height < 2)
+    {
+        m_width = m_height = 0;
+        return;
+    }
+
+    m_previousRow.resize(width);
+    for (int k = 0; k < 2; k++)
+    {
+        m_horizontalHeads[k].assign(width - 1, -1);
+        m_horizontalTails[k].assign(width - 1, -1);
+    }
+    m_verticalHeads.assign(width, -1);
+    m_verticalTails.assign(width, -1);
+}
+
+void StreamingContourTracer::addRows(const float* rows, int rowCount)
+{
+    if (rows == nullptr)
+        return;
+
+    // Only the last row of a batch is copied; the others are read in place
+    const float* previous = m_previousRow.data();
+    for (int r = 0; r < rowCount && m_rowCount < m_height; r++)
+    {
+        const float* row = rows + static_cast<size_t>(r) * m_width;
+        if (m_rowCount > 0)
+            addCellRow(previous, row);
+        previous = row;
+        m_rowCount++;
+    }
+
+    if (previous != m_previousRow.data())
+        std::copy(previous, previous + m_width, m_previousRow.begin());
+}
+
+void StreamingContourTracer::addCellRow(const float* bottom, const float* top)
+{
+    // Cell row y lies between sample rows y and y + 1 = m_rowCount
+    const int y = m_rowCount - 1;
+    const int cellsX = m_width - 1;
+    const float y0 = m_minY + y * m_cellHeight;
+    const float y1 = m_minY + (y + 1) * m_cellHeight;
+    const int64_t rowCell = static_cast<int64_t>(y) * cellsX;
+    const int64_t bottomEdge = static_cast<int64_t>(y) * m_width * 2;
+    const int64_t topEdge = bottomEdge + static_cast<int64_t>(m_width) * 2;
+
+    for (int x = 0; x < cellsX; x++)
+    {
+        const int cellCase = ((bottom[x] > m_isoValue) ? 1 : 0) | ((bottom[x + 1] > m_isoValue) ? 2 : 0) |
+                             ((top[x + 1] > m_isoValue) ? 4 : 0) | ((top[x] > m_isoValue) ? 8 : 0);
+        if (cellCase == 0 || cellCase == 15)
+            continue;
+
+        const float x0 = m_minX + x * m_cellWidth;
+        const float x1 = m_minX + (x + 1) * m_cellWidth;
+
+        // Edge keys: horizontal edge (row, x) is 2 * (row * width + x),
+        // vertical edge (cell row, column) the same plus one
+        const int64_t edgeKeys[4] = {
+            bottomEdge + 2 * x,            // Bottom
+            bottomEdge + 2 * (x + 1) + 1,  // Right
+            topEdge + 2 * x,               // Top
+            bottomEdge + 2 * x + 1         // Left
+        };
+
+        for (int entry = 0; entry < 4; entry++)
+        {
+            const int exit = TRACE_NEXT[cellCase][entry];
+            if (exit < 0)
+                continue;
+
+            addSegment(rowCell + x, entry, edgeKeys[entry], edgeKeys[exit],
+                       traceEdgePoint(bottom + x, top + x, x0, x1, y0, y1, m_isoValue, entry),
+                       traceEdgePoint(bottom + x, top + x, x0, x1, y0, y1, m_isoValue, exit));
+        }
+    }
+}
+
+int* StreamingContourTracer::endSlot(int64_t key, bool head)
+{
+    // Edges on the grid border end a contour for good: no slot
+    const int64_t index = key >> 1;
+    const int row = static_cast<int>(index / m_width);
+    const int column = static_cast<int>(index % m_width);
+
+    if (key & 1)
+    {
+        if (column == 0 || column == m_width - 1)
+            return nullptr;
+        return head ? &m_verticalHeads[column] : &m_verticalTails[column];
+    }
+
+    if (row == 0 || row == m_height - 1)
+        return nullptr;
+    return head ? &m_horizontalHeads[row & 1][column] : &m_horizontalTails[row & 1][column];
+}
+
+void StreamingContourTracer::addSegment(int64_t cell, int entry,
+                                        int64_t entryKey, int64_t exitKey,
+                                        const Point2D& entryPoint, const Point2D& exitPoint)
+{
+    // The chain ending where this segment starts, and the one starting
+    // where it ends
+    int* tailSlot = endSlot(entryKey, false);
+    int* headSlot = endSlot(exitKey, true);
+    const int before = tailSlot ? *tailSlot : -1;
+    const int after = headSlot ? *headSlot : -1;
+
+    int chain;
+    if (before >= 0 && after >= 0)
+    {
+        *tailSlot = -1;
+        *headSlot = -1;
+        if (before == after)
+        {
+            emitChain(before, true);
+            return;
+        }
+
+        // Join before + after, moving the shorter one
+        Chain& first = m_chains[before];
+        Chain& second = m_chains[after];
+        const size_t firstSize = first.points.size();
+        const bool secondSeed = second.seedCell * 4 + second.seedEntry < first.seedCell * 4 + first.seedEntry;
+
+        if (firstSize >= second.points.size())
+        {
+            first.points.insert(first.points.end(), second.points.begin(), second.points.end());
+            if (secondSeed)
+            {
+                first.seedCell = second.seedCell;
+                first.seedEntry = second.seedEntry;
+                first.seedPos = firstSize + second.seedPos;
+            }
+            first.tailKey = second.tailKey;
+            if (int* slot = endSlot(first.tailKey, false))
+                *slot = before;
+            chain = before;
+            m_freeChains.push_back(after);
+            std::deque<Point2D>().swap(second.points);
+            second.headKey = second.tailKey = -1;
+        }
+        else
+        {
+            second.points.insert(second.points.begin(), first.points.begin(), first.points.end());
+            if (secondSeed)
+            {
+                second.seedPos += firstSize;
+            }
+            else
+            {
+                second.seedCell = first.seedCell;
+                second.seedEntry = first.seedEntry;
+                second.seedPos = first.seedPos;
+            }
+            second.headKey = first.headKey;
+            if (int* slot = endSlot(second.headKey, true))
+                *slot = after;
+            chain = after;
+            m_freeChains.push_back(before);
+            std::deque<Point2D>().swap(first.points);
+            first.headKey = first.tailKey = -1;
+        }
+    }
+    else if (before >= 0)
+    {
+        *tailSlot = -1;
+        Chain& c = m_chains[before];
+        c.points.push_back(exitPoint);
+        c.tailKey = exitKey;
+        if (int* slot = endSlot(exitKey, false))
+            *slot = before;
+        chain = before;
+    }
+    else if (after >= 0)
+    {
+        // Segments arrive in row-major order, so the chain keeps its seed
+        *headSlot = -1;
+        Chain& c = m_chains[after];
+        c.points.push_front(entryPoint);
+        c.seedPos++;
+        c.headKey = entryKey;
+        if (int* slot = endSlot(entryKey, true))
+            *slot = after;
+        chain = after;
+    }
+    else
+    {
+        if (!m_freeChains.empty())
+        {
+            chain = m_freeChains.back();
+            m_freeChains.pop_back();
+        }
+        else
+        {
+            chain = static_cast<int>(m_chains.size());
+            m_chains.push_back(Chain());
+        }
+
+        Chain& c = m_chains[chain];
+        c.points.push_back(entryPoint);
+        c.points.push_back(exitPoint);
+        c.headKey = entryKey;
+        c.tailKey = exitKey;
+        c.seedCell = cell;
+        c.seedEntry = entry;
+        c.seedPos = 0;
+        if (int* slot = endSlot(entryKey, true))
+            *slot = chain;
+        if (int* slot = endSlot(exitKey, false))
+            *slot = chain;
+    }
+
+    // Both ends on the grid border: the contour is complete
+    const Chain& c = m_chains[chain];
+    if (endSlot(c.headKey, true) == nullptr && endSlot(c.tailKey, false) == nullptr)
+        emitChain(chain, false);
+}
+
+void StreamingContourTracer::emitChain(int chain, bool closed)
+{
+    Chain& c = m_chains[chain];
+
+    IsoContour contour;
+    contour.closed = closed;
+    contour.signedArea = 0.0f;
+    contour.parent = -1;
+    contour.depth = 0;
+
+    // traceIsoContours() starts a loop at its seed's entry point
+    const size_t start = closed ? c.seedPos : 0;
+    contour.points.reserve(c.points.size());
+    contour.points.insert(contour.points.end(), c.points.begin() + start, c.points.end());
+    contour.points.insert(contour.points.end(), c.points.begin(), c.points.begin() + start);
+
+    m_contours.push_back(contour);
+    m_contourSeeds.push_back(c.seedCell * 4 + c.seedEntry);
+
+    std::deque<Point2D>().swap(c.points);
+    c.headKey = c.tailKey = -1;
+    m_freeChains.push_back(chain);
+}
+
+std::vector<IsoContour> StreamingContourTracer::finish()
+{
+    // Contours cut off by missing rows are returned open
+    for (size_t k = 0; k < m_chains.size(); k++)
+    {
+        if (m_chains[k].headKey >= 0)
+            emitChain(static_cast<int>(k), false);
+    }
+
+    // Order of the seed cells, as the seed scan of traceIsoContours()
+    std::vector<size_t> order(m_contours.size());
+    for (size_t k = 0; k < order.size(); k++)
+        order[k] = k;
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+    {
+        return m_contourSeeds[a] < m_contourSeeds[b];
+    });
+
+    std::vector<IsoContour> contours(order.size());
+    for (size_t k = 0; k < order.size(); k++)
+        std::swap(contours[k], m_contours[order[k]]);
+
+    m_contours.clear();
+    m_contourSeeds.clear();
+    m_chains.clear();
+    m_freeChains.clear();
+
+    buildContourHierarchy(contours);
+    return contours;
+}
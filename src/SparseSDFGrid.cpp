@@ -0,0 +1,326 @@
+#include "SparseSDFGrid.h"
+#include "ThreadPool.h"
+#include "sdf_backends.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SparseSDFGrid::SparseSDFGrid()
+    : m_width(0)
+    , m_height(0)
+    , m_brickSize(0)
+    , m_bricksX(0)
+    , m_bricksY(0)
+    , m_worldMinX(0.0f)
+    , m_worldMaxX(0.0f)
+    , m_worldMinY(0.0f)
+    , m_worldMaxY(0.0f)
+    , m_stepX(0.0f)
+    , m_stepY(0.0f)
+    , m_bandWidth(0.0f)
+{
+}
+
+void SparseSDFGrid::clear()
+{
+    m_width = m_height = 0;
+    m_bricksX = m_bricksY = 0;
+    m_brickTable.clear();
+    m_brickData.clear();
+}
+
+bool SparseSDFGrid::generate(int width, int height,
+                             float worldMinX, float worldMaxX,
+                             float worldMinY, float worldMaxY,
+                             const PreparedPolygon& prepared,
+                             float bandWidth,
+                             int brickSize,
+                             int threadCount)
+{
+    clear();
+
+    const float stepX = (worldMaxX - worldMinX) / width;
+    const float stepY = (worldMaxY - worldMinY) / height;
+    if (width <= 0 || height <= 0 || brickSize <= 0 || !(stepX > 0.0f) || !(stepY > 0.0f))
+    {
+        std::cerr << "SparseSDFGrid: Invalid grid dimensions" << std::endl;
+        return false;
+    }
+
+    if (prepared.edgeCount < 3)
+    {
+        std::cerr << "SparseSDFGrid: Invalid polygon" << std::endl;
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_brickSize = brickSize;
+    m_bricksX = (width + brickSize - 1) / brickSize;
+    m_bricksY = (height + brickSize - 1) / brickSize;
+    m_worldMinX = worldMinX;
+    m_worldMaxX = worldMaxX;
+    m_worldMinY = worldMinY;
+    m_worldMaxY = worldMaxY;
+    m_stepX = stepX;
+    m_stepY = stepY;
+
+    // Contour cells need exact corners on both sides of the boundary
+    m_bandWidth = std::max(bandWidth, 2.0f * std::max(stepX, stepY));
+
+    const int brickCount = m_bricksX * m_bricksY;
+
+    // Step 1: find the bricks within the band of every edge. Each edge is
+    // walked in pieces of at most one brick, the band-expanded bounding box
+    // of every piece marks bricks. Bricks keep the list of edges that marked
+    // them (CSR), which contains the nearest edge of every in-band sample.
+    std::vector<int> brickStart(brickCount + 1, 0);
+    std::vector<int> brickEdges;
+    std::vector<int> fill;
+    std::vector<int> lastEdge(brickCount, -1);
+
+    // Counts the bricks of edge i into brickStart, or stores it when filling
+    auto visitEdgeBricks = [&](int i, bool store)
+    {
+        const float dx = prepared.dirX[i];
+        const float dy = prepared.dirY[i];
+        const float cellsX = std::fabs(dx) / (stepX * brickSize);
+        const float cellsY = std::fabs(dy) / (stepY * brickSize);
+        const int pieces = std::max(1, static_cast<int>(std::ceil(std::max(cellsX, cellsY))));
+
+        for (int piece = 0; piece < pieces; piece++)
+        {
+            float t0 = static_cast<float>(piece) / pieces;
+            float t1 = static_cast<float>(piece + 1) / pieces;
+            float ax = prepared.originX[i] + dx * t0;
+            float ay = prepared.originY[i] + dy * t0;
+            float bx = prepared.originX[i] + dx * t1;
+            float by = prepared.originY[i] + dy * t1;
+
+            // Samples within the expanded box, one sample of slack for rounding
+            float xLow = std::floor((std::min(ax, bx) - m_bandWidth - worldMinX) / stepX - 0.5f) - 1.0f;
+            float xHigh = std::ceil((std::max(ax, bx) + m_bandWidth - worldMinX) / stepX - 0.5f) + 1.0f;
+            float yLow = std::floor((std::min(ay, by) - m_bandWidth - worldMinY) / stepY - 0.5f) - 1.0f;
+            float yHigh = std::ceil((std::max(ay, by) + m_bandWidth - worldMinY) / stepY - 0.5f) + 1.0f;
+            if (xHigh < 0.0f || yHigh < 0.0f || xLow > width - 1 || yLow > height - 1)
+                continue;
+
+            int brickX0 = static_cast<int>(std::max(0.0f, xLow)) / brickSize;
+            int brickX1 = static_cast<int>(std::min(static_cast<float>(width - 1), xHigh)) / brickSize;
+            int brickY0 = static_cast<int>(std::max(0.0f, yLow)) / brickSize;
+            int brickY1 = static_cast<int>(std::min(static_cast<float>(height - 1), yHigh)) / brickSize;
+
+            for (int by0 = brickY0; by0 <= brickY1; by0++)
+            {
+                for (int bx0 = brickX0; bx0 <= brickX1; bx0++)
+                {
+                    int brick = by0 * m_bricksX + bx0;
+                    if (lastEdge[brick] == i)
+                        continue;
+                    lastEdge[brick] = i;
+
+                    if (store)
+                        brickEdges[fill[brick]++] = i;
+                    else
+                        brickStart[brick + 1]++;
+                }
+            }
+        }
+    };
+
+    for (int i = 0; i < prepared.edgeCount; i++)
+        visitEdgeBricks(i, false);
+
+    for (int brick = 0; brick < brickCount; brick++)
+        brickStart[brick + 1] += brickStart[brick];
+
+    brickEdges.resize(brickStart[brickCount]);
+    fill.assign(brickStart.begin(), brickStart.end() - 1);
+    std::fill(lastEdge.begin(), lastEdge.end(), -1);
+    for (int i = 0; i < prepared.edgeCount; i++)
+        visitEdgeBricks(i, true);
+
+    // Assign storage to the marked bricks
+    const int brickArea = brickSize * brickSize;
+    m_brickTable.assign(brickCount, FAR_OUTSIDE);
+    int activeCount = 0;
+    for (int brick = 0; brick < brickCount; brick++)
+    {
+        if (brickStart[brick + 1] > brickStart[brick])
+            m_brickTable[brick] = activeCount++;
+    }
+    m_brickData.assign(static_cast<size_t>(activeCount) * brickArea, m_bandWidth);
+
+    // Step 2: per brick row, classify the sample rows with the scanline pass,
+    // then fill the stored bricks and set the sign of the far bricks
+    ScanlineRows rows(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY, prepared);
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+
+    ThreadPool::shared().parallelFor(m_bricksY, threads, [&](int brickY)
+    {
+        const int rowBegin = brickY * brickSize;
+        const int rowCount = std::min(brickSize, height - rowBegin);
+
+        std::vector<unsigned char> insideRows(static_cast<size_t>(rowCount) * width);
+        std::vector<int> delta;
+        for (int r = 0; r < rowCount; r++)
+            rows.classifyRow(rowBegin + r, delta, insideRows.data() + r * width);
+
+        for (int brickX = 0; brickX < m_bricksX; brickX++)
+        {
+            const int brick = brickY * m_bricksX + brickX;
+            const int columnBegin = brickX * brickSize;
+            const int slot = m_brickTable[brick];
+
+            if (slot < 0)
+            {
+                // No boundary within the band: the whole brick has one sign
+                m_brickTable[brick] = insideRows[columnBegin] ? FAR_INSIDE : FAR_OUTSIDE;
+                continue;
+            }
+
+            const int columnCount = std::min(brickSize, width - columnBegin);
+            const int edgeBegin = brickStart[brick];
+            const int edgeEnd = brickStart[brick + 1];
+            float* values = m_brickData.data() + static_cast<size_t>(slot) * brickArea;
+
+            for (int r = 0; r < rowCount; r++)
+            {
+                const float py = worldMinY + (rowBegin + r + 0.5f) * stepY;
+                for (int c = 0; c < columnCount; c++)
+                {
+                    const float px = worldMinX + (columnBegin + c + 0.5f) * stepX;
+                    float dist = m_bandWidth;
+                    for (int j = edgeBegin; j < edgeEnd; j++)
+                        dist = std::min(dist, preparedEdgeDistance(prepared, brickEdges[j], px, py));
+
+                    values[r * brickSize + c] = insideRows[r * width + columnBegin + c] ? -dist : dist;
+                }
+            }
+        }
+    });
+
+    return true;
+}
+
+float SparseSDFGrid::getValue(int x, int y) const
+{
+    const int slot = m_brickTable[(y / m_brickSize) * m_bricksX + x / m_brickSize];
+    if (slot >= 0)
+    {
+        return m_brickData[static_cast<size_t>(slot) * m_brickSize * m_brickSize +
+                           (y % m_brickSize) * m_brickSize + x % m_brickSize];
+    }
+    return (slot == FAR_INSIDE) ? -m_bandWidth : m_bandWidth;
+}
+
+float SparseSDFGrid::sample(const Point2D& point) const
+{
+    if (!isValid())
+        return 0.0f;
+
+    // Continuous sample coordinates, clamped to the sample area
+    float gx = clamp((point.x - m_worldMinX) / m_stepX - 0.5f, 0.0f, static_cast<float>(m_width - 1));
+    float gy = clamp((point.y - m_worldMinY) / m_stepY - 0.5f, 0.0f, static_cast<float>(m_height - 1));
+
+    int x0 = static_cast<int>(gx);
+    int y0 = static_cast<int>(gy);
+    int x1 = std::min(x0 + 1, m_width - 1);
+    int y1 = std::min(y0 + 1, m_height - 1);
+    float fx = gx - x0;
+    float fy = gy - y0;
+
+    float bottom = lerp(getValue(x0, y0), getValue(x1, y0), fx);
+    float top = lerp(getValue(x0, y1), getValue(x1, y1), fx);
+    return lerp(bottom, top, fy);
+}
+
+std::vector<Point2D> SparseSDFGrid::extractIsoContour(float isoValue, int threadCount) const
+{
+    std::vector<Point2D> contourPoints;
+
+    if (!isValid() || m_width < 2 || m_height < 2)
+        return contourPoints;
+
+    if (std::fabs(isoValue) >= m_bandWidth)
+    {
+        std::cerr << "SparseSDFGrid: isoValue " << isoValue
+                  << " is outside the stored band" << std::endl;
+        return contourPoints;
+    }
+
+    auto isStored = [&](int brickX, int brickY)
+    {
+        return brickX < m_bricksX && brickY < m_bricksY &&
+               m_brickTable[brickY * m_bricksX + brickX] >= 0;
+    };
+
+    // Same cell layout as the dense extractIsoContour(): sample x sits at
+    // worldMinX + x * cellWidth, so both storages give the same contours
+    const float cellWidth = (m_worldMaxX - m_worldMinX) / (m_width - 1);
+    const float cellHeight = (m_worldMaxY - m_worldMinY) / (m_height - 1);
+
+    // A cell belongs to the brick of its bottom-left corner; its other
+    // corners may lie in the bricks to the right and above
+    auto extractBrickRow = [&](int brickY, std::vector<Point2D>& out)
+    {
+        for (int brickX = 0; brickX < m_bricksX; brickX++)
+        {
+            if (!isStored(brickX, brickY) && !isStored(brickX + 1, brickY) &&
+                !isStored(brickX, brickY + 1) && !isStored(brickX + 1, brickY + 1))
+            {
+                continue;
+            }
+
+            const int yEnd = std::min((brickY + 1) * m_brickSize, m_height - 1);
+            const int xEnd = std::min((brickX + 1) * m_brickSize, m_width - 1);
+            for (int y = brickY * m_brickSize; y < yEnd; y++)
+            {
+                const float y0 = m_worldMinY + y * cellHeight;
+                const float y1 = m_worldMinY + (y + 1) * cellHeight;
+                for (int x = brickX * m_brickSize; x < xEnd; x++)
+                {
+                    appendMarchingSquaresCell(
+                        getValue(x, y), getValue(x + 1, y),
+                        getValue(x + 1, y + 1), getValue(x, y + 1),
+                        m_worldMinX + x * cellWidth, m_worldMinX + (x + 1) * cellWidth,
+                        y0, y1, isoValue, out);
+                }
+            }
+        }
+    };
+
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+    if (threads <= 1 || m_bricksY < 2)
+    {
+        for (int brickY = 0; brickY < m_bricksY; brickY++)
+            extractBrickRow(brickY, contourPoints);
+        return contourPoints;
+    }
+
+    std::vector<std::vector<Point2D> > rowPoints(m_bricksY);
+    ThreadPool::shared().parallelFor(m_bricksY, threads, [&](int brickY)
+    {
+        extractBrickRow(brickY, rowPoints[brickY]);
+    });
+
+    size_t total = 0;
+    for (int brickY = 0; brickY < m_bricksY; brickY++)
+        total += rowPoints[brickY].size();
+
+    contourPoints.reserve(total);
+    for (int brickY = 0; brickY < m_bricksY; brickY++)
+        contourPoints.insert(contourPoints.end(), rowPoints[brickY].begin(), rowPoints[brickY].end());
+
+    return contourPoints;
+}
+
+int SparseSDFGrid::getActiveBrickCount() const
+{
+    return static_cast<int>(m_brickSize > 0 ? m_brickData.size() / (m_brickSize * m_brickSize) : 0);
+}
+
+size_t SparseSDFGrid::getMemoryUsage() const
+{
+    return m_brickTable.size() * sizeof(int) + m_brickData.size() * sizeof(float);
+}
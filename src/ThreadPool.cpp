@@ -0,0 +1,139 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(int workerCount)
+    : m_stopping(false)
+{
+    if (workerCount <= 0)
+        workerCount = resolveThreadCount(0) - 1;
+
+    for (int i = 0; i < workerCount; i++)
+    {
+        m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stopping && m_jobs.empty())
+                m_condition.wait(lock);
+
+            if (m_jobs.empty())
+                return;  // Stopping and nothing left to run
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+        job();
+    }
+}
+
+void ThreadPool::parallelFor(int taskCount, int maxThreads,
+                             const std::function<void(int)>& task)
+{
+    if (taskCount <= 0)
+        return;
+
+    int threads = getWorkerCount() + 1;
+    if (maxThreads > 0)
+        threads = std::min(threads, maxThreads);
+    threads = std::min(threads, taskCount);
+
+    // Serial fast path: no synchronization at all
+    if (threads <= 1)
+    {
+        for (int i = 0; i < taskCount; i++)
+            task(i);
+        return;
+    }
+
+    // Shared between the caller and the helper jobs. Helpers may still be
+    // sitting in the queue after the caller returns, so it is ref-counted.
+    struct SharedState {
+        std::atomic<int> nextTask;
+        int finishedTasks;
+        std::mutex mutex;
+        std::condition_variable done;
+        const std::function<void(int)>* task;
+        int taskCount;
+    };
+
+    std::shared_ptr<SharedState> state = std::make_shared<SharedState>();
+    state->nextTask = 0;
+    state->finishedTasks = 0;
+    state->task = &task;
+    state->taskCount = taskCount;
+
+    // Claims tasks until none are left. A helper that starts late finds the
+    // counter exhausted and never touches the task pointer.
+    std::function<void()> runTasks = [state]()
+    {
+        int finished = 0;
+        for (;;)
+        {
+            int index = state->nextTask.fetch_add(1);
+            if (index >= state->taskCount)
+                break;
+            (*state->task)(index);
+            finished++;
+        }
+
+        if (finished > 0)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->finishedTasks += finished;
+            if (state->finishedTasks == state->taskCount)
+                state->done.notify_all();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < threads - 1; i++)
+            m_jobs.push(runTasks);
+    }
+    m_condition.notify_all();
+
+    // The caller works too, then waits for tasks claimed by helpers
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->finishedTasks < state->taskCount)
+        state->done.wait(lock);
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::resolveThreadCount(int threadCount)
+{
+    if (threadCount > 0)
+        return threadCount;
+
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(hardware, 1);
+}
@@ -1,4 +1,7 @@
 #include "sdf.h"
+#include "ThreadPool.h"
+#include "sdf_simd.h"
+#include "sdf_backends.h"
 #include <algorithm>
 #include <limits>
 
@@ -83,6 +86,76 @@ bool isPointInPolygon(const Point2D& p, const std::vector<Point2D>& polygon)
     return winding != 0;
 }
 
+/**
+ * @brief Offset (ex, ey) from the nearest point of an edge to p, returns its
+ *        squared length
+ */
+static inline float edgeOffset(float px, float py,
+                               float ax, float ay, float dx, float dy,
+                               float invLengthSq, float& ex, float& ey)
+{
+    float pax = px - ax;
+    float pay = py - ay;
+    
+    // Projection parameter, clamped to the segment (degenerate edges: t = 0)
+    float t = (pax * dx + pay * dy) * invLengthSq;
+    t = clamp(t, 0.0f, 1.0f);
+    
+    ex = pax - dx * t;
+    ey = pay - dy * t;
+    return ex * ex + ey * ey;
+}
+
+/**
+ * @brief Add the winding contribution of one edge
+ * 
+ * Same crossing rules as isPointInPolygon(): upward edges count points
+ * strictly left of them, downward edges points strictly right.
+ */
+static inline void accumulateWinding(float px, float py,
+                                     float ax, float ay, float dx, float dy,
+                                     float minY, float maxY, int& winding)
+{
+    if (py >= minY && py < maxY)
+    {
+        float cross = dx * (py - ay) - (px - ax) * dy;
+        if (dy > 0)
+        {
+            if (cross > 0)
+                winding++;
+        }
+        else if (cross < 0)
+        {
+            winding--;
+        }
+    }
+}
+
+/**
+ * @brief Accumulate one edge into the running squared distance and winding number
+ * 
+ * Shared by every SDF evaluator (and mirrored lane-for-lane by the SIMD row
+ * kernels) so that all paths produce identical values.
+ */
+static inline void accumulateEdge(float px, float py,
+                                  float ax, float ay, float dx, float dy,
+                                  float invLengthSq, float minY, float maxY,
+                                  float& minDistSq, int& winding)
+{
+    float ex, ey;
+    minDistSq = std::min(minDistSq, edgeOffset(px, py, ax, ay, dx, dy, invLengthSq, ex, ey));
+    accumulateWinding(px, py, ax, ay, dx, dy, minY, maxY, winding);
+}
+
+/**
+ * @brief Inverse squared length of an edge, 0 for degenerate edges
+ */
+static inline float inverseLengthSq(float dx, float dy)
+{
+    float lengthSq = dx * dx + dy * dy;
+    return (lengthSq < 1e-10f) ? 0.0f : 1.0f / lengthSq;
+}
+
 /**
  * @brief Calculate the signed distance field value for a point relative to a polygon
  */
@@ -94,23 +167,149 @@ float calculatePolygonSDF(const Point2D& p, const std::vector<Point2D>& polygon)
         return std::numeric_limits<float>::max();
     }
     
-    // Find minimum distance to any edge
-    float minDist = std::numeric_limits<float>::max();
-    int n = polygon.size();
+    // Single pass: minimum distance to any edge plus winding number
+    float minDistSq = std::numeric_limits<float>::max();
+    int winding = 0;
+    
+    const Point2D* a = &polygon.back();  // Closing edge first
+    for (size_t i = 0; i < polygon.size(); i++)
+    {
+        const Point2D* b = &polygon[i];
+        float dx = b->x - a->x;
+        float dy = b->y - a->y;
+        
+        accumulateEdge(p.x, p.y, a->x, a->y, dx, dy, inverseLengthSq(dx, dy),
+                       std::min(a->y, b->y), std::max(a->y, b->y),
+                       minDistSq, winding);
+        a = b;
+    }
+    
+    float minDist = std::sqrt(minDistSq);
+    return winding != 0 ? -minDist : minDist;
+}
+
+/**
+ * @brief Precompute per-edge data of a polygon
+ */
+void preparePolygon(const std::vector<Point2D>& polygon, PreparedPolygon& prepared)
+{
+    int n = (polygon.size() < 3) ? 0 : static_cast<int>(polygon.size());
+    
+    prepared.originX.resize(n);
+    prepared.originY.resize(n);
+    prepared.dirX.resize(n);
+    prepared.dirY.resize(n);
+    prepared.invLengthSq.resize(n);
+    prepared.minY.resize(n);
+    prepared.maxY.resize(n);
+    prepared.edgeCount = n;
     
+    // Edge order matches calculatePolygonSDF(): closing edge first
     for (int i = 0; i < n; i++)
     {
-        const Point2D& a = polygon[i];
-        const Point2D& b = polygon[(i + 1) % n];
+        const Point2D& a = polygon[(i == 0) ? n - 1 : i - 1];
+        const Point2D& b = polygon[i];
         
-        float dist = pointToSegmentDistance(p, a, b);
-        minDist = std::min(minDist, dist);
+        prepared.originX[i] = a.x;
+        prepared.originY[i] = a.y;
+        prepared.dirX[i] = b.x - a.x;
+        prepared.dirY[i] = b.y - a.y;
+        prepared.invLengthSq[i] = inverseLengthSq(prepared.dirX[i], prepared.dirY[i]);
+        prepared.minY[i] = std::min(a.y, b.y);
+        prepared.maxY[i] = std::max(a.y, b.y);
     }
+}
+
+/**
+ * @brief Calculate the signed distance field value against a prepared polygon
+ */
+float calculatePreparedSDF(const Point2D& p, const PreparedPolygon& prepared)
+{
+    if (prepared.edgeCount < 3)
+        return std::numeric_limits<float>::max();
+    
+    float minDistSq = std::numeric_limits<float>::max();
+    int winding = 0;
     
-    // Determine if point is inside or outside and apply sign
-    bool inside = isPointInPolygon(p, polygon);
+    for (int i = 0; i < prepared.edgeCount; i++)
+    {
+        accumulateEdge(p.x, p.y,
+                       prepared.originX[i], prepared.originY[i],
+                       prepared.dirX[i], prepared.dirY[i],
+                       prepared.invLengthSq[i],
+                       prepared.minY[i], prepared.maxY[i],
+                       minDistSq, winding);
+    }
     
-    return inside ? -minDist : minDist;
+    float minDist = std::sqrt(minDistSq);
+    return winding != 0 ? -minDist : minDist;
+}
+
+/**
+ * @brief Nonzero winding test against a prepared polygon
+ */
+static bool isInsidePrepared(const Point2D& p, const PreparedPolygon& prepared)
+{
+    int winding = 0;
+    for (int i = 0; i < prepared.edgeCount; i++)
+    {
+        accumulateWinding(p.x, p.y, prepared.originX[i], prepared.originY[i],
+                          prepared.dirX[i], prepared.dirY[i],
+                          prepared.minY[i], prepared.maxY[i], winding);
+    }
+    return winding != 0;
+}
+
+/**
+ * @brief Signed distance and its gradient against a prepared polygon
+ */
+float calculatePreparedSDFGradient(const Point2D& p, const PreparedPolygon& prepared,
+                                   Point2D& outGradient)
+{
+    outGradient.x = 0.0f;
+    outGradient.y = 0.0f;
+    if (prepared.edgeCount < 3)
+        return std::numeric_limits<float>::max();
+    
+    // Same pass as calculatePreparedSDF(), keeping the offset to the
+    // nearest edge (first one on ties, like std::min)
+    float minDistSq = std::numeric_limits<float>::max();
+    float nearestX = 0.0f, nearestY = 0.0f;
+    int nearest = 0;
+    int winding = 0;
+    
+    for (int i = 0; i < prepared.edgeCount; i++)
+    {
+        float ex, ey;
+        float distSq = edgeOffset(p.x, p.y, prepared.originX[i], prepared.originY[i],
+                                  prepared.dirX[i], prepared.dirY[i],
+                                  prepared.invLengthSq[i], ex, ey);
+        if (distSq < minDistSq)
+        {
+            minDistSq = distSq;
+            nearestX = ex;
+            nearestY = ey;
+            nearest = i;
+        }
+        accumulateWinding(p.x, p.y, prepared.originX[i], prepared.originY[i],
+                          prepared.dirX[i], prepared.dirY[i],
+                          prepared.minY[i], prepared.maxY[i], winding);
+    }
+    
+    float minDist = std::sqrt(minDistSq);
+    float edgeExtent = std::fabs(prepared.dirX[nearest]) + std::fabs(prepared.dirY[nearest]);
+    if (!isOnBoundary(p, minDist, edgeExtent))
+    {
+        outGradient = offsetGradient(nearestX, nearestY, minDist, winding != 0);
+    }
+    else
+    {
+        outGradient = boundaryGradient(prepared, nearest, p, [&](const Point2D& q)
+        {
+            return isInsidePrepared(q, prepared);
+        });
+    }
+    return winding != 0 ? -minDist : minDist;
 }
 
 /**
@@ -121,6 +320,37 @@ void generateSDFGrid(int width, int height,
                      float worldMinY, float worldMaxY,
                      const std::vector<Point2D>& polygon,
                      float* sdfData)
+{
+    generateSDFGrid(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                    polygon, sdfData, SDFGridOptions());
+}
+
+/**
+ * @brief Generate a 2D SDF grid with explicit generation options
+ */
+void generateSDFGrid(int width, int height,
+                     float worldMinX, float worldMaxX,
+                     float worldMinY, float worldMaxY,
+                     const std::vector<Point2D>& polygon,
+                     float* sdfData,
+                     const SDFGridOptions& options)
+{
+    PreparedPolygon prepared;
+    preparePolygon(polygon, prepared);
+    
+    generateSDFGrid(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                    prepared, sdfData, options);
+}
+
+/**
+ * @brief Generate a 2D SDF grid from a prepared polygon
+ */
+void generateSDFGrid(int width, int height,
+                     float worldMinX, float worldMaxX,
+                     float worldMinY, float worldMaxY,
+                     const PreparedPolygon& prepared,
+                     float* sdfData,
+                     const SDFGridOptions& options)
 {
     if (sdfData == nullptr || width <= 0 || height <= 0)
         return;
@@ -129,24 +359,169 @@ void generateSDFGrid(int width, int height,
     float stepX = (worldMaxX - worldMinX) / width;
     float stepY = (worldMaxY - worldMinY) / height;
     
-    // Sample SDF at each grid point
-    for (int y = 0; y < height; y++)
+    // Invalid polygon: every sample is "far outside", as in calculatePolygonSDF()
+    if (prepared.edgeCount < 3)
+    {
+        std::fill(sdfData, sdfData + width * height, std::numeric_limits<float>::max());
+        return;
+    }
+    
+    if (options.method == SDFGridMethod::DistanceTransform &&
+        generateSDFGridEDT(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                           prepared, sdfData, options.threadCount))
     {
-        for (int x = 0; x < width; x++)
+        return;
+    }
+    
+    if (options.method == SDFGridMethod::CharacteristicScan &&
+        generateSDFGridCSC(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                           prepared, options.maxDistance, sdfData, options.threadCount))
+    {
+        return;
+    }
+    
+    SDFRowKernel rowKernel = options.useSIMD ? getSDFRowKernel() : computeSDFRowScalar;
+    
+    // Signs for the whole grid in one scanline pass; the kernels then only
+    // compute distances
+    std::vector<unsigned char> insideMask;
+    if (options.useScanlineSign)
+    {
+        insideMask.resize(width * height);
+        computeInsideMask(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                          prepared, insideMask.data(), options.threadCount);
+    }
+    
+    // Sample SDF at the cell centers of rows [rowBegin, rowEnd), row-major
+    auto generateRows = [&](int rowBegin, int rowEnd)
+    {
+        for (int y = rowBegin; y < rowEnd; y++)
         {
-            // Calculate world position for this grid cell
-            Point2D worldPos = {
-                worldMinX + (x + 0.5f) * stepX,  // Center of the cell
-                worldMinY + (y + 0.5f) * stepY
-            };
-            
-            // Calculate SDF value
-            float sdf = calculatePolygonSDF(worldPos, polygon);
-            
-            // Store in row-major order
-            sdfData[y * width + x] = sdf;
+            rowKernel(prepared, worldMinX, stepX, worldMinY + (y + 0.5f) * stepY,
+                      width, sdfData + y * width,
+                      insideMask.empty() ? nullptr : insideMask.data() + y * width);
+        }
+    };
+    
+    int threads = ThreadPool::resolveThreadCount(options.threadCount);
+    if (threads <= 1 || height < 2)
+    {
+        generateRows(0, height);
+        return;
+    }
+    
+    // Several bands per thread so that rows crossing the polygon (expensive)
+    // and rows far from it (cheap) still balance out
+    const int rowsPerBand = std::max(1, height / (threads * 4));
+    const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+    
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        int rowBegin = band * rowsPerBand;
+        generateRows(rowBegin, std::min(rowBegin + rowsPerBand, height));
+    });
+}
+
+/**
+ * @brief Distances and gradients of a grid with the given output strides
+ */
+static void generateGradientRows(int width, int height,
+                                 float worldMinX, float worldMaxX,
+                                 float worldMinY, float worldMaxY,
+                                 const PreparedPolygon& prepared,
+                                 float* distances, int distanceStride,
+                                 float* gradients, int gradientStride,
+                                 const SDFGridOptions& options)
+{
+    float stepX = (worldMaxX - worldMinX) / width;
+    float stepY = (worldMaxY - worldMinY) / height;
+    
+    // Invalid polygon: "far outside" with a zero gradient, as in
+    // calculatePreparedSDFGradient()
+    if (prepared.edgeCount < 3)
+    {
+        for (size_t k = 0; k < static_cast<size_t>(width) * height; k++)
+        {
+            distances[k * distanceStride] = std::numeric_limits<float>::max();
+            gradients[k * gradientStride] = 0.0f;
+            gradients[k * gradientStride + 1] = 0.0f;
         }
+        return;
     }
+    
+    SDFGradientRowKernel rowKernel = options.useSIMD ? getSDFGradientRowKernel()
+                                                     : computeSDFGradientRowScalar;
+    const size_t distanceRow = static_cast<size_t>(width) * distanceStride;
+    const size_t gradientRow = static_cast<size_t>(width) * gradientStride;
+    
+    auto generateRows = [&](int rowBegin, int rowEnd)
+    {
+        for (int y = rowBegin; y < rowEnd; y++)
+        {
+            rowKernel(prepared, worldMinX, stepX, worldMinY + (y + 0.5f) * stepY, width,
+                      distances + y * distanceRow, distanceStride,
+                      gradients + y * gradientRow, gradientStride);
+        }
+    };
+    
+    int threads = ThreadPool::resolveThreadCount(options.threadCount);
+    if (threads <= 1 || height < 2)
+    {
+        generateRows(0, height);
+        return;
+    }
+    
+    // Same banding as generateSDFGrid()
+    const int rowsPerBand = std::max(1, height / (threads * 4));
+    const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+    
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        int rowBegin = band * rowsPerBand;
+        generateRows(rowBegin, std::min(rowBegin + rowsPerBand, height));
+    });
+}
+
+/**
+ * @brief Generate an SDF grid and its gradient field in separate buffers
+ */
+void generateSDFGradientGrid(int width, int height,
+                             float worldMinX, float worldMaxX,
+                             float worldMinY, float worldMaxY,
+                             const PreparedPolygon& prepared,
+                             float* sdfData, Point2D* gradientData,
+                             const SDFGridOptions& options)
+{
+    if (sdfData == nullptr || gradientData == nullptr || width <= 0 || height <= 0)
+        return;
+    
+    generateGradientRows(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY, prepared,
+                         sdfData, 1, reinterpret_cast<float*>(gradientData), 2, options);
+}
+
+/**
+ * @brief Generate an SDF grid and its gradient field interleaved in one buffer
+ */
+void generateSDFGradientGridInterleaved(int width, int height,
+                                        float worldMinX, float worldMaxX,
+                                        float worldMinY, float worldMaxY,
+                                        const PreparedPolygon& prepared,
+                                        float* data,
+                                        const SDFGridOptions& options)
+{
+    if (data == nullptr || width <= 0 || height <= 0)
+        return;
+    
+    generateGradientRows(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY, prepared,
+                         data, 3, data + 1, 3, options);
+}
+
+/**
+ * @brief Get the name of the vectorized grid kernel selected for this CPU
+ */
+const char* getSIMDKernelName()
+{
+    return getSDFRowKernelName();
 }
 
 /**
@@ -223,130 +598,45 @@ static float calculateContourLength(const std::vector<Point2D>& contour)
     return totalLength;
 }
 
-/**
- * @brief Connect line segments into an ordered closed contour
- */
-std::vector<Point2D> connectLineSegments(const std::vector<Point2D>& segments)
-{
-    std::vector<Point2D> contour;
-    
-    if (segments.size() < 4) // Need at least 2 line segments (4 points)
-        return contour;
-    
-    // Convert pairs of points into edges
-    struct Edge {
-        Point2D p0, p1;
-        bool used;
-    };
-    
-    std::vector<Edge> edges;
-    for (size_t i = 0; i < segments.size(); i += 2)
-    {
-        if (i + 1 < segments.size())
-        {
-            edges.push_back({segments[i], segments[i + 1], false});
-        }
-    }
-    
-    if (edges.empty())
-        return contour;
-    
-    // Start with the first edge
-    contour.push_back(edges[0].p0);
-    contour.push_back(edges[0].p1);
-    edges[0].used = true;
-    
-    Point2D currentEnd = edges[0].p1;
-    const float epsilon = 0.001f;
-    
-    // Greedily connect edges
-    bool foundNext = true;
-    while (foundNext && contour.size() < edges.size() * 2)
-    {
-        foundNext = false;
-        
-        for (size_t i = 1; i < edges.size(); i++)
-        {
-            if (edges[i].used)
-                continue;
-            
-            // Check if this edge connects to current end
-            float dist0 = distance(currentEnd, edges[i].p0);
-            float dist1 = distance(currentEnd, edges[i].p1);
-            
-            if (dist0 < epsilon)
-            {
-                // Connect via p0 -> p1
-                contour.push_back(edges[i].p1);
-                currentEnd = edges[i].p1;
-                edges[i].used = true;
-                foundNext = true;
-                break;
-            }
-            else if (dist1 < epsilon)
-            {
-                // Connect via p1 -> p0
-                contour.push_back(edges[i].p0);
-                currentEnd = edges[i].p0;
-                edges[i].used = true;
-                foundNext = true;
-                break;
-            }
-        }
-    }
-    
-    // Remove duplicate points (especially closing point)
-    if (contour.size() > 1)
-    {
-        float closingDist = distance(contour.back(), contour.front());
-        if (closingDist < epsilon)
-        {
-            contour.pop_back();
-        }
-    }
-    
-    return contour;
-}
-
 /**
  * @brief Resample a contour to have uniformly distributed points
  */
-std::vector<Point2D> resampleContour(const std::vector<Point2D>& contour, int targetCount)
+void resampleContour(const std::vector<Point2D>& contour, int targetCount,
+                     std::vector<Point2D>& out)
 {
-    std::vector<Point2D> resampled;
+    out.clear();
     
     if (contour.size() < 2 || targetCount < 3)
-        return resampled;
+        return;
     
     // Calculate total length
     float totalLength = calculateContourLength(contour);
     if (totalLength < 0.001f)
-        return resampled;
+        return;
     
     float segmentLength = totalLength / targetCount;
     
     // Always start with the first point
-    resampled.push_back(contour[0]);
+    out.push_back(contour[0]);
     
     float accumulatedLength = 0.0f;
     float nextSampleDistance = segmentLength;
     
-    // Build a closed contour for iteration
-    std::vector<Point2D> closedContour = contour;
+    // Walk the contour as a closed loop: the closing edge back to the
+    // first point is added unless the contour already ends there
+    size_t edgeCount = contour.size() - 1;
     if (distance(contour.back(), contour.front()) > 0.001f)
-    {
-        closedContour.push_back(contour.front());
-    }
+        edgeCount++;
     
-    // Walk along the contour and sample points
-    for (size_t i = 0; i < closedContour.size() - 1; i++)
+    const size_t target = static_cast<size_t>(targetCount);
+    for (size_t i = 0; i < edgeCount; i++)
     {
-        Point2D p0 = closedContour[i];
-        Point2D p1 = closedContour[i + 1];
+        Point2D p0 = contour[i];
+        Point2D p1 = contour[(i + 1) % contour.size()];
         float edgeLength = distance(p0, p1);
         
         // Check if we need to sample on this edge
-        while (accumulatedLength + edgeLength >= nextSampleDistance && resampled.size() < targetCount)
+        while (accumulatedLength + edgeLength >= nextSampleDistance && out.size() < target)
         {
             // Calculate interpolation parameter
             float remainingDistance = nextSampleDistance - accumulatedLength;
@@ -358,30 +648,38 @@ std::vector<Point2D> resampleContour(const std::vector<Point2D>& contour, int ta
                 lerp(p0.y, p1.y, t)
             };
             
-            resampled.push_back(sample);
+            out.push_back(sample);
             nextSampleDistance += segmentLength;
         }
         
         accumulatedLength += edgeLength;
         
-        if (resampled.size() >= targetCount)
+        if (out.size() >= target)
             break;
     }
-    
+}
+
+std::vector<Point2D> resampleContour(const std::vector<Point2D>& contour, int targetCount)
+{
+    std::vector<Point2D> resampled;
+    resampleContour(contour, targetCount, resampled);
     return resampled;
 }
 
 /**
- * @brief Triangulate the ring region between two contours
+ * @brief Resample both ring contours to a common point count
+ * @return Points per contour, 0 on failure
  */
-std::vector<Triangle> triangulateRing(
-    const std::vector<Point2D>& outerContour,
-    const std::vector<Point2D>& innerContour)
+static size_t resampleRingContours(const std::vector<Point2D>& outerContour,
+                                   const std::vector<Point2D>& innerContour,
+                                   std::vector<Point2D>& outer,
+                                   std::vector<Point2D>& inner)
 {
-    std::vector<Triangle> triangles;
+    outer.clear();
+    inner.clear();
     
     if (outerContour.size() < 3 || innerContour.size() < 3)
-        return triangles;
+        return 0;
     
     // Determine target point count (use the larger one, minimum 32)
     int targetCount = std::max(
@@ -391,15 +689,28 @@ std::vector<Triangle> triangulateRing(
     targetCount = std::max(targetCount, 32);
     
     // Resample both contours to have the same number of points
-    std::vector<Point2D> outer = resampleContour(outerContour, targetCount);
-    std::vector<Point2D> inner = resampleContour(innerContour, targetCount);
+    resampleContour(outerContour, targetCount, outer);
+    resampleContour(innerContour, targetCount, inner);
     
     // Make sure both resampling succeeded
     if (outer.size() < 3 || inner.size() < 3)
-        return triangles;
+        return 0;
     
     // Use the minimum size in case resampling didn't produce exact counts
-    size_t pointCount = std::min(outer.size(), inner.size());
+    return std::min(outer.size(), inner.size());
+}
+
+/**
+ * @brief Triangulate the ring region between two contours
+ */
+std::vector<Triangle> triangulateRing(
+    const std::vector<Point2D>& outerContour,
+    const std::vector<Point2D>& innerContour)
+{
+    std::vector<Triangle> triangles;
+    std::vector<Point2D> outer, inner;
+    size_t pointCount = resampleRingContours(outerContour, innerContour, outer, inner);
+    triangles.reserve(pointCount * 2);
     
     // Generate triangle strip
     for (size_t i = 0; i < pointCount; i++)
@@ -424,6 +735,35 @@ std::vector<Triangle> triangulateRing(
     return triangles;
 }
 
+int triangulateRing(const std::vector<Point2D>& outerContour,
+                    const std::vector<Point2D>& innerContour,
+                    std::vector<Point2D>& outVertices,
+                    std::vector<Point2D>& resampledOuter,
+                    std::vector<Point2D>& resampledInner)
+{
+    size_t pointCount = resampleRingContours(outerContour, innerContour,
+                                             resampledOuter, resampledInner);
+    const std::vector<Point2D>& outer = resampledOuter;
+    const std::vector<Point2D>& inner = resampledInner;
+    
+    // Same strip as above, written straight into the vertex array
+    outVertices.resize(pointCount * 6);
+    Point2D* v = outVertices.empty() ? nullptr : &outVertices[0];
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        size_t next = (i + 1) % pointCount;
+        v[0] = outer[i];
+        v[1] = inner[i];
+        v[2] = outer[next];
+        v[3] = outer[next];
+        v[4] = inner[i];
+        v[5] = inner[next];
+        v += 6;
+    }
+    
+    return static_cast<int>(pointCount * 2);
+}
+
 /**
  * @brief Convert triangles to flat vertex array for rendering
  */
@@ -442,6 +782,77 @@ std::vector<Point2D> trianglesToVertices(const std::vector<Triangle>& triangles)
     return vertices;
 }
 
+// Marching Squares lookup table for edge intersections
+// Each entry represents which edges to connect for a given case
+// Edges: 0=bottom, 1=right, 2=top, 3=left
+static const int MARCHING_SQUARES_EDGES[16][4] = {
+    {-1, -1, -1, -1}, // Case 0: no intersection
+    {0, 3, -1, -1},   // Case 1: bottom-left
+    {0, 1, -1, -1},   // Case 2: bottom-right
+    {1, 3, -1, -1},   // Case 3: bottom edge
+    {1, 2, -1, -1},   // Case 4: top-right
+    {0, 3, 1, 2},     // Case 5: ambiguous (saddle)
+    {0, 2, -1, -1},   // Case 6: right edge
+    {2, 3, -1, -1},   // Case 7: top-right corner
+    {2, 3, -1, -1},   // Case 8: top-left
+    {0, 2, -1, -1},   // Case 9: left edge
+    {0, 1, 2, 3},     // Case 10: ambiguous (saddle)
+    {1, 2, -1, -1},   // Case 11: top-left corner
+    {1, 3, -1, -1},   // Case 12: top edge
+    {0, 1, -1, -1},   // Case 13: top-right corner
+    {0, 3, -1, -1},   // Case 14: bottom-left corner
+    {-1, -1, -1, -1}  // Case 15: no intersection
+};
+
+/**
+ * @brief Marching Squares for one cell, appends its segments to out
+ */
+void appendMarchingSquaresCell(float v0, float v1, float v2, float v3,
+                               float x0, float x1, float y0, float y1,
+                               float isoValue, std::vector<Point2D>& out)
+{
+    // Calculate case index (4-bit value)
+    int caseIndex = 0;
+    if (v0 > isoValue) caseIndex |= 1;
+    if (v1 > isoValue) caseIndex |= 2;
+    if (v2 > isoValue) caseIndex |= 4;
+    if (v3 > isoValue) caseIndex |= 8;
+    
+    // Skip if no intersection
+    if (caseIndex == 0 || caseIndex == 15)
+        return;
+    
+    // Calculate intersection points on edges using linear interpolation
+    Point2D edgePoints[4];
+    
+    // Edge 0: bottom (v0 to v1)
+    float t0 = (isoValue - v0) / (v1 - v0);
+    edgePoints[0] = {lerp(x0, x1, t0), y0};
+    
+    // Edge 1: right (v1 to v2)
+    float t1 = (isoValue - v1) / (v2 - v1);
+    edgePoints[1] = {x1, lerp(y0, y1, t1)};
+    
+    // Edge 2: top (v3 to v2)
+    float t2 = (isoValue - v3) / (v2 - v3);
+    edgePoints[2] = {lerp(x0, x1, t2), y1};
+    
+    // Edge 3: left (v0 to v3)
+    float t3 = (isoValue - v0) / (v3 - v0);
+    edgePoints[3] = {x0, lerp(y0, y1, t3)};
+    
+    // Add line segments based on the lookup table
+    const int* edges = MARCHING_SQUARES_EDGES[caseIndex];
+    for (int i = 0; i < 4 && edges[i] != -1; i += 2)
+    {
+        if (i + 1 < 4 && edges[i + 1] != -1)
+        {
+            out.push_back(edgePoints[edges[i]]);
+            out.push_back(edgePoints[edges[i + 1]]);
+        }
+    }
+}
+
 /**
  * @brief Extract iso-contour from SDF grid using Marching Squares algorithm
  */
@@ -449,7 +860,8 @@ std::vector<Point2D> extractIsoContour(const float* sdfData,
                                        int width, int height,
                                        float worldMinX, float worldMaxX,
                                        float worldMinY, float worldMaxY,
-                                       float isoValue)
+                                       float isoValue,
+                                       int threadCount)
 {
     std::vector<Point2D> contourPoints;
     
@@ -460,87 +872,153 @@ std::vector<Point2D> extractIsoContour(const float* sdfData,
     float cellWidth = (worldMaxX - worldMinX) / (width - 1);
     float cellHeight = (worldMaxY - worldMinY) / (height - 1);
     
-    // Marching Squares lookup table for edge intersections
-    // Each entry represents which edges to connect for a given case
-    // Edges: 0=bottom, 1=right, 2=top, 3=left
-    const int edgeTable[16][4] = {
-        {-1, -1, -1, -1}, // Case 0: no intersection
-        {0, 3, -1, -1},   // Case 1: bottom-left
-        {0, 1, -1, -1},   // Case 2: bottom-right
-        {1, 3, -1, -1},   // Case 3: bottom edge
-        {1, 2, -1, -1},   // Case 4: top-right
-        {0, 3, 1, 2},     // Case 5: ambiguous (saddle)
-        {0, 2, -1, -1},   // Case 6: right edge
-        {2, 3, -1, -1},   // Case 7: top-right corner
-        {2, 3, -1, -1},   // Case 8: top-left
-        {0, 2, -1, -1},   // Case 9: left edge
-        {0, 1, 2, 3},     // Case 10: ambiguous (saddle)
-        {1, 2, -1, -1},   // Case 11: top-left corner
-        {1, 3, -1, -1},   // Case 12: top edge
-        {0, 1, -1, -1},   // Case 13: top-right corner
-        {0, 3, -1, -1},   // Case 14: bottom-left corner
-        {-1, -1, -1, -1}  // Case 15: no intersection
+    // Process the 2x2 cells of rows [rowBegin, rowEnd), row-major
+    auto extractRows = [&](int rowBegin, int rowEnd, std::vector<Point2D>& out)
+    {
+        for (int y = rowBegin; y < rowEnd; y++)
+        {
+            const float* bottom = sdfData + y * width;
+            const float* top = bottom + width;
+            
+            // Skip cells whose corners are all on the same side cheaply
+            bool leftAbove = bottom[0] > isoValue;
+            bool leftMixed = leftAbove != (top[0] > isoValue);
+            for (int x = 0; x < width - 1; x++)
+            {
+                bool rightAbove = bottom[x + 1] > isoValue;
+                bool rightMixed = rightAbove != (top[x + 1] > isoValue);
+                bool crossed = leftMixed || rightMixed || leftAbove != rightAbove;
+                leftAbove = rightAbove;
+                leftMixed = rightMixed;
+                if (!crossed)
+                    continue;
+                
+                // Corners: bottom-left, bottom-right, top-right, top-left
+                appendMarchingSquaresCell(
+                    bottom[x], bottom[x + 1], top[x + 1], top[x],
+                    worldMinX + x * cellWidth, worldMinX + (x + 1) * cellWidth,
+                    worldMinY + y * cellHeight, worldMinY + (y + 1) * cellHeight,
+                    isoValue, out);
+            }
+        }
     };
     
-    // Process each 2x2 cell in the grid
-    for (int y = 0; y < height - 1; y++)
+    const int cellRows = height - 1;
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+    if (threads <= 1 || cellRows < 2)
     {
-        for (int x = 0; x < width - 1; x++)
+        extractRows(0, cellRows, contourPoints);
+        return contourPoints;
+    }
+    
+    // Several bands per thread: contour cells are unevenly spread
+    const int rowsPerBand = std::max(1, cellRows / (threads * 4));
+    const int bandCount = (cellRows + rowsPerBand - 1) / rowsPerBand;
+    std::vector<std::vector<Point2D> > bandPoints(bandCount);
+    
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        int rowBegin = band * rowsPerBand;
+        extractRows(rowBegin, std::min(cellRows, rowBegin + rowsPerBand), bandPoints[band]);
+    });
+    
+    // Concatenate in band order: same order as the single-threaded loop
+    std::vector<size_t> bandOffsets(bandCount + 1, 0);
+    for (int band = 0; band < bandCount; band++)
+        bandOffsets[band + 1] = bandOffsets[band] + bandPoints[band].size();
+    
+    contourPoints.resize(bandOffsets[bandCount]);
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        std::copy(bandPoints[band].begin(), bandPoints[band].end(),
+                  contourPoints.begin() + bandOffsets[band]);
+    });
+    
+    return contourPoints;
+}
+
+/**
+ * @brief Extract several iso-contours in one sweep over the grid
+ */
+std::vector<std::vector<Point2D> > extractIsoContours(const float* sdfData,
+                                                      int width, int height,
+                                                      float worldMinX, float worldMaxX,
+                                                      float worldMinY, float worldMaxY,
+                                                      const std::vector<float>& isoValues,
+                                                      int threadCount)
+{
+    const int levelCount = static_cast<int>(isoValues.size());
+    std::vector<std::vector<Point2D> > levelPoints(levelCount);
+    
+    if (sdfData == nullptr || width < 2 || height < 2 || levelCount == 0 ||
+        !std::is_sorted(isoValues.begin(), isoValues.end()))
+    {
+        return levelPoints;
+    }
+    
+    float cellWidth = (worldMaxX - worldMinX) / (width - 1);
+    float cellHeight = (worldMaxY - worldMinY) / (height - 1);
+    
+    // Each cell is loaded once; its value range selects the crossing levels
+    auto extractRows = [&](int rowBegin, int rowEnd, std::vector<std::vector<Point2D> >& out)
+    {
+        for (int y = rowBegin; y < rowEnd; y++)
         {
-            // Get the 4 corner values
-            float v0 = sdfData[y * width + x];           // bottom-left
-            float v1 = sdfData[y * width + (x + 1)];     // bottom-right
-            float v2 = sdfData[(y + 1) * width + (x + 1)]; // top-right
-            float v3 = sdfData[(y + 1) * width + x];     // top-left
-            
-            // Calculate case index (4-bit value)
-            int caseIndex = 0;
-            if (v0 > isoValue) caseIndex |= 1;
-            if (v1 > isoValue) caseIndex |= 2;
-            if (v2 > isoValue) caseIndex |= 4;
-            if (v3 > isoValue) caseIndex |= 8;
-            
-            // Skip if no intersection
-            if (caseIndex == 0 || caseIndex == 15)
-                continue;
-            
-            // Calculate world coordinates of cell corners
-            float x0 = worldMinX + x * cellWidth;
-            float x1 = worldMinX + (x + 1) * cellWidth;
-            float y0 = worldMinY + y * cellHeight;
-            float y1 = worldMinY + (y + 1) * cellHeight;
-            
-            // Calculate intersection points on edges using linear interpolation
-            Point2D edgePoints[4];
-            
-            // Edge 0: bottom (v0 to v1)
-            float t0 = (isoValue - v0) / (v1 - v0);
-            edgePoints[0] = {lerp(x0, x1, t0), y0};
-            
-            // Edge 1: right (v1 to v2)
-            float t1 = (isoValue - v1) / (v2 - v1);
-            edgePoints[1] = {x1, lerp(y0, y1, t1)};
-            
-            // Edge 2: top (v3 to v2)
-            float t2 = (isoValue - v3) / (v2 - v3);
-            edgePoints[2] = {lerp(x0, x1, t2), y1};
-            
-            // Edge 3: left (v0 to v3)
-            float t3 = (isoValue - v0) / (v3 - v0);
-            edgePoints[3] = {x0, lerp(y0, y1, t3)};
-            
-            // Add line segments based on the lookup table
-            const int* edges = edgeTable[caseIndex];
-            for (int i = 0; i < 4 && edges[i] != -1; i += 2)
+            const float* bottom = sdfData + y * width;
+            const float* top = bottom + width;
+            for (int x = 0; x < width - 1; x++)
             {
-                if (i + 1 < 4 && edges[i + 1] != -1)
+                float v0 = bottom[x], v1 = bottom[x + 1], v2 = top[x + 1], v3 = top[x];
+                float lo = std::min(std::min(v0, v1), std::min(v2, v3));
+                float hi = std::max(std::max(v0, v1), std::max(v2, v3));
+                int first = crossingLevelBegin(isoValues, lo);
+                if (first == levelCount || isoValues[first] >= hi)
+                    continue;
+                
+                int last = crossingLevelBegin(isoValues, hi);
+                for (int level = first; level < last; level++)
                 {
-                    contourPoints.push_back(edgePoints[edges[i]]);
-                    contourPoints.push_back(edgePoints[edges[i + 1]]);
+                    appendMarchingSquaresCell(
+                        v0, v1, v2, v3,
+                        worldMinX + x * cellWidth, worldMinX + (x + 1) * cellWidth,
+                        worldMinY + y * cellHeight, worldMinY + (y + 1) * cellHeight,
+                        isoValues[level], out[level]);
                 }
             }
         }
+    };
+    
+    const int cellRows = height - 1;
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+    if (threads <= 1 || cellRows < 2)
+    {
+        extractRows(0, cellRows, levelPoints);
+        return levelPoints;
     }
     
-    return contourPoints;
+    // Bands as in extractIsoContour(), one buffer per band and level
+    const int rowsPerBand = std::max(1, cellRows / (threads * 4));
+    const int bandCount = (cellRows + rowsPerBand - 1) / rowsPerBand;
+    std::vector<std::vector<std::vector<Point2D> > > bandPoints(
+        bandCount, std::vector<std::vector<Point2D> >(levelCount));
+    
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        int rowBegin = band * rowsPerBand;
+        extractRows(rowBegin, std::min(cellRows, rowBegin + rowsPerBand), bandPoints[band]);
+    });
+    
+    ThreadPool::shared().parallelFor(levelCount, threads, [&](int level)
+    {
+        size_t total = 0;
+        for (int band = 0; band < bandCount; band++)
+            total += bandPoints[band][level].size();
+        
+        std::vector<Point2D>& out = levelPoints[level];
+        out.reserve(total);
+        for (int band = 0; band < bandCount; band++)
+            out.insert(out.end(), bandPoints[band][level].begin(), bandPoints[band][level].end());
+    });
+    
+    return levelPoints;
 }
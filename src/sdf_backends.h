@@ -0,0 +1,299 @@
+#ifndef SDF_BACKENDS_H
+#define SDF_BACKENDS_H
+
+#include "sdf.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class EdgeBVH;
+
+/**
+ * @file sdf_backends.h
+ * @brief Internal grid generation backends (not part of the public API)
+ *
+ * All backends sample the same grid as generateSDFGrid(): sample (x, y) is
+ * located at (worldMinX + (x + 0.5) * stepX, worldMinY + (y + 0.5) * stepY)
+ * with stepX = (worldMaxX - worldMinX) / width, likewise for Y.
+ */
+
+/**
+ * @brief Exact distance from a point to edge i of a prepared polygon
+ *
+ * Same float operations as calculatePreparedSDF(), so backends built on it
+ * reproduce Exact bit for bit wherever they pick the right edge.
+ */
+inline float preparedEdgeDistance(const PreparedPolygon& prepared, int i, float px, float py)
+{
+    float pax = px - prepared.originX[i];
+    float pay = py - prepared.originY[i];
+    float t = clamp((pax * prepared.dirX[i] + pay * prepared.dirY[i]) * prepared.invLengthSq[i], 0.0f, 1.0f);
+    float ex = pax - prepared.dirX[i] * t;
+    float ey = pay - prepared.dirY[i] * t;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+/**
+ * @brief Whether p is too close to an edge for its offset to have a direction
+ *
+ * Offsets within the rounding of the coordinates they are computed from
+ * (p and an edge of extent |dx| + |dy|) point anywhere; such samples are
+ * treated as on the boundary.
+ */
+inline bool isOnBoundary(const Point2D& p, float dist, float edgeExtent)
+{
+    return !(dist > 1e-5f * (std::fabs(p.x) + std::fabs(p.y) + edgeExtent));
+}
+
+/**
+ * @brief SDF gradient from the offset (ex, ey) of p to its nearest boundary point
+ *
+ * The unit vector away from the boundary, negated inside. dist is the
+ * offset's length, off the boundary (see isOnBoundary()).
+ */
+inline Point2D offsetGradient(float ex, float ey, float dist, bool inside)
+{
+    Point2D gradient = {ex / dist, ey / dist};
+    if (inside)
+    {
+        gradient.x = -gradient.x;
+        gradient.y = -gradient.y;
+    }
+    return gradient;
+}
+
+/**
+ * @brief SDF gradient at a point p on edge i (see isOnBoundary()): the edge
+ *        normal pointing out of the polygon
+ *
+ * The side is found by testing a point just off the edge with
+ * isInside(const Point2D&). The test point is taken off the middle half of
+ * the edge: next to a vertex it could land beyond the other edge there and
+ * flip the normal. (0, 0) for a degenerate edge.
+ */
+template <typename InsideTest>
+Point2D boundaryGradient(const PreparedPolygon& prepared, int i, const Point2D& p,
+                         InsideTest isInside)
+{
+    Point2D normal = {0.0f, 0.0f};
+    float length = std::sqrt(prepared.dirX[i] * prepared.dirX[i] + prepared.dirY[i] * prepared.dirY[i]);
+    if (prepared.invLengthSq[i] == 0.0f || !(length > 0.0f))
+        return normal;
+
+    normal.x = prepared.dirY[i] / length;
+    normal.y = -prepared.dirX[i] / length;
+    const float offset = 1e-3f * length;
+    float pax = p.x - prepared.originX[i];
+    float pay = p.y - prepared.originY[i];
+    float t = clamp((pax * prepared.dirX[i] + pay * prepared.dirY[i]) * prepared.invLengthSq[i], 0.25f, 0.75f);
+    Point2D probe = {prepared.originX[i] + prepared.dirX[i] * t + normal.x * offset,
+                     prepared.originY[i] + prepared.dirY[i] * t + normal.y * offset};
+    if (isInside(probe))
+    {
+        normal.x = -normal.x;
+        normal.y = -normal.y;
+    }
+    return normal;
+}
+
+/**
+ * @brief Per-row edge crossings of a grid, for row-by-row sign classification
+ *
+ * Edges are bucketed by the sample rows they cross once (O(E + crossings));
+ * classifyRow() then fills one row from a difference array in O(crossings
+ * + W). The per-sample decision uses the same predicate as
+ * calculatePreparedSDF(), so the result matches its sign exactly.
+ * computeInsideMask() runs it over whole grids.
+ * The prepared polygon must outlive this object.
+ */
+class ScanlineRows {
+public:
+    ScanlineRows(int width, int height,
+                 float worldMinX, float worldMaxX,
+                 float worldMinY, float worldMaxY,
+                 const PreparedPolygon& prepared);
+
+    /**
+     * @brief Classify row y (1 = inside, 0 = outside)
+     * @param delta Scratch buffer, reused between calls
+     * @param row Output, width bytes
+     */
+    void classifyRow(int y, std::vector<int>& delta, unsigned char* row) const;
+
+private:
+    const PreparedPolygon& m_prepared;
+    int m_width;
+    float m_worldMinX, m_worldMinY;
+    float m_stepX, m_stepY;
+    std::vector<int> m_rowStart;  // CSR offsets into m_rowEdges, height + 1
+    std::vector<int> m_rowEdges;  // Edges crossing each row
+};
+
+/**
+ * @brief Marching Squares for one cell (shared by all contour extractors)
+ *
+ * Corners v0..v3 are bottom-left, bottom-right, top-right, top-left; the
+ * cell spans [x0, x1] x [y0, y1]. Segments are appended as point pairs.
+ */
+void appendMarchingSquaresCell(float v0, float v1, float v2, float v3,
+                               float x0, float x1, float y0, float y1,
+                               float isoValue, std::vector<Point2D>& out);
+
+/**
+ * @brief Oriented Marching Squares table of the contour tracers
+ *
+ * TRACE_NEXT[case][entry] is the edge the contour leaves a cell by when it
+ * enters through edge entry, or -1. Edges: 0=bottom, 1=right, 2=top,
+ * 3=left. Case bits: 1 = bottom-left, 2 = bottom-right, 4 = top-right,
+ * 8 = top-left sample above isoValue.
+ */
+extern const int TRACE_NEXT[16][4];
+
+/**
+ * @brief Crossing point on one edge of a cell, for the contour tracers
+ *
+ * bottom/top point at the cell's lower-left and upper-left samples; the
+ * cell spans [x0, x1] x [y0, y1]. Interpolated from the lower sample index
+ * of the grid edge, so both cells sharing it agree.
+ */
+inline Point2D traceEdgePoint(const float* bottom, const float* top,
+                              float x0, float x1, float y0, float y1,
+                              float isoValue, int edge)
+{
+    Point2D p;
+    switch (edge)
+    {
+    case 0:  p = {lerp(x0, x1, (isoValue - bottom[0]) / (bottom[1] - bottom[0])), y0}; break;
+    case 1:  p = {x1, lerp(y0, y1, (isoValue - bottom[1]) / (top[1] - bottom[1]))}; break;
+    case 2:  p = {lerp(x0, x1, (isoValue - top[0]) / (top[1] - top[0])), y1}; break;
+    default: p = {x0, lerp(y0, y1, (isoValue - bottom[0]) / (top[0] - bottom[0]))}; break;
+    }
+    return p;
+}
+
+/**
+ * @brief Index of the first of the ascending levels that is >= value
+ *
+ * The levels crossing a cell whose samples span [lo, hi] (some sample
+ * above the level, some not) are [crossingLevelBegin(levels, lo),
+ * crossingLevelBegin(levels, hi)).
+ */
+inline int crossingLevelBegin(const std::vector<float>& levels, float value)
+{
+    return static_cast<int>(std::lower_bound(levels.begin(), levels.end(), value) - levels.begin());
+}
+
+/**
+ * @brief Distance transform backend (see SDFGridMethod::DistanceTransform)
+ *
+ * @return false if the backend cannot handle the input (the caller should
+ *         fall back to the exact path)
+ */
+bool generateSDFGridEDT(int width, int height,
+                        float worldMinX, float worldMaxX,
+                        float worldMinY, float worldMaxY,
+                        const PreparedPolygon& prepared,
+                        float* sdfData,
+                        int threadCount);
+
+/**
+ * @brief One scan-converted region: a convex polygon plus its feature
+ */
+struct CharacteristicRegion {
+    Point2D corners[4];
+    int edges[2];  // Feature edges: the slab's edge twice, or a wedge's two edges
+};
+
+/**
+ * @brief Characteristic regions of a polygon bucketed by row band
+ *        (see SDFGridMethod::CharacteristicScan)
+ *
+ * fillBand() writes the unsigned distances of one band of rowsPerBand rows,
+ * clamped to maxDistance; the caller applies the signs. Bands can be
+ * filled in any order and in parallel. The prepared polygon must outlive
+ * this object.
+ */
+class CharacteristicBands {
+public:
+    CharacteristicBands(int width, int height,
+                        float worldMinX, float worldMaxX,
+                        float worldMinY, float worldMaxY,
+                        const PreparedPolygon& prepared,
+                        float maxDistance, int rowsPerBand);
+
+    int getBandCount() const { return m_bandCount; }
+
+    /**
+     * @param band Band index
+     * @param rows Output, the band's rows (row-major, width floats each)
+     */
+    void fillBand(int band, float* rows) const;
+
+private:
+    const PreparedPolygon& m_prepared;
+    int m_width, m_height;
+    float m_worldMinX, m_worldMinY;
+    float m_stepX, m_stepY;
+    float m_maxDistance;
+    int m_rowsPerBand, m_bandCount;
+    std::vector<CharacteristicRegion> m_regions;
+    std::vector<int> m_regionRowBegin, m_regionRowEnd;  // Rows each region reaches
+    std::vector<int> m_bandStart;                       // CSR offsets into m_bandRegions
+    std::vector<int> m_bandRegions;
+};
+
+/**
+ * @brief Characteristic scan-conversion backend
+ *        (see SDFGridMethod::CharacteristicScan)
+ *
+ * Exact within maxDistance, clamped to +/-maxDistance beyond it.
+ *
+ * @return false if the backend cannot handle the input (the caller should
+ *         fall back to the exact path)
+ */
+bool generateSDFGridCSC(int width, int height,
+                        float worldMinX, float worldMaxX,
+                        float worldMinY, float worldMaxY,
+                        const PreparedPolygon& prepared,
+                        float maxDistance,
+                        float* sdfData,
+                        int threadCount);
+
+/**
+ * @brief Batched signed distance queries (see SDFProcessor::querySDFValues())
+ *
+ * Point k is (xs[k * stride], ys[k * stride]). Uses the vectorized points
+ * kernel for small polygons and the edge index for large ones; large
+ * batches are split over the thread pool. The polygon must be valid.
+ */
+void querySDFBatch(const PreparedPolygon& prepared, const EdgeBVH& index,
+                   const float* xs, const float* ys, size_t stride,
+                   size_t count, float* out,
+                   int threadCount, bool useSIMD);
+
+/**
+ * @brief Refresh a dense Exact grid in place after some edges changed
+ *
+ * oldEdges/newEdges hold the replaced edges before and after the edit;
+ * sweptTriangles (3 points each) must cover the region between them, where
+ * the sign can change. index is built over the edited polygon. Only
+ * samples that can be affected are recomputed; results match a full
+ * regeneration. changedTiles receives one flag per tileSize x tileSize
+ * tile (row-major).
+ *
+ * @return Number of samples whose value changed
+ */
+int updateSDFGridEdges(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const PreparedPolygon& oldEdges,
+                       const PreparedPolygon& newEdges,
+                       const Point2D* sweptTriangles, int triangleCount,
+                       const EdgeBVH& index,
+                       int tileSize,
+                       float* sdfData,
+                       std::vector<unsigned char>& changedTiles,
+                       int threadCount);
+
+#endif // SDF_BACKENDS_H
@@ -0,0 +1,478 @@
+#include "sdf.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+
+/**
+ * @file sdf_contours.cpp
+ * @brief Segment connection and contour nesting
+ *
+ * connectAllLineSegments() matches segment endpoints through a hash grid
+ * and walks the resulting chains; buildContourHierarchy() finds, for the
+ * leftmost vertex of every closed contour, the nearest contour edge to its
+ * left with one sweep over the y-monotone runs of all edges. That edge's
+ * contour is the parent if the vertex lies on its inner side, otherwise
+ * the two share a parent.
+ */
+
+namespace
+{
+
+/**
+ * @brief y-monotone run of contour edges for the nesting sweep
+ *
+ * Vertices [begin, end) of the chain arrays, in ascending y.
+ */
+struct SweepChain {
+    int begin, end;
+    int contour;    // Index into the contour list
+    bool goesDown;  // Walking direction of the contour along the chain
+};
+
+/**
+ * @brief Orders active chains by their x at the current sweep line
+ *
+ * Chains never cross, so the order of two active chains does not change
+ * while the sweep line moves. Index -1 is the query point.
+ */
+struct SweepOrder {
+    const std::vector<SweepChain>* chains;
+    const std::vector<float>* chainX;
+    const std::vector<float>* chainY;
+    const float* sweepY;
+    const float* queryX;
+
+    // Edge of chain c at the sweep line: the one starting at or below it
+    int edgeAt(int c) const
+    {
+        const SweepChain& chain = (*chains)[c];
+        const float* ys = &(*chainY)[0];
+        int k = static_cast<int>(std::upper_bound(ys + chain.begin, ys + chain.end, *sweepY) - ys) - 1;
+        return std::max(chain.begin, std::min(k, chain.end - 2));
+    }
+
+    float slope(int k) const
+    {
+        return ((*chainX)[k + 1] - (*chainX)[k]) / ((*chainY)[k + 1] - (*chainY)[k]);
+    }
+
+    bool operator()(int a, int b) const
+    {
+        int ka = (a < 0) ? -1 : edgeAt(a);
+        int kb = (b < 0) ? -1 : edgeAt(b);
+        float xa = (a < 0) ? *queryX : (*chainX)[ka] + (*sweepY - (*chainY)[ka]) * slope(ka);
+        float xb = (b < 0) ? *queryX : (*chainX)[kb] + (*sweepY - (*chainY)[kb]) * slope(kb);
+        if (xa != xb)
+            return xa < xb;
+        if (a < 0 || b < 0)
+            return a < 0 && b >= 0;  // Query point before chains through it
+        // Chains starting at the same vertex: order above it
+        float sa = slope(ka);
+        float sb = slope(kb);
+        if (sa != sb)
+            return sa < sb;
+        return a < b;
+    }
+};
+
+/**
+ * @brief Sweep event; at equal y, removals come before insertions and
+ * insertions before queries, so chains are active on [lowY, highY)
+ */
+struct SweepEvent {
+    float y;
+    int type;  // 0 = remove chain, 1 = insert chain, 2 = query contour
+    int index;
+
+    bool operator<(const SweepEvent& other) const
+    {
+        if (y != other.y)
+            return y < other.y;
+        return type < other.type;
+    }
+};
+
+} // namespace
+
+void buildContourHierarchy(std::vector<IsoContour>& contours)
+{
+    const int count = static_cast<int>(contours.size());
+    std::vector<SweepChain> chains;
+    std::vector<float> chainX, chainY;
+    std::vector<SweepEvent> events;
+    std::vector<Point2D> leftmost(count);
+    std::vector<Point2D> run;
+
+    int closedCount = 0;
+    for (int c = 0; c < count; c++)
+    {
+        if (contours[c].closed && contours[c].points.size() >= 3)
+            closedCount++;
+    }
+
+    for (int c = 0; c < count; c++)
+    {
+        IsoContour& contour = contours[c];
+        const std::vector<Point2D>& points = contour.points;
+        const size_t n = points.size();
+
+        double area = 0.0;
+        bool finite = true;
+        for (size_t i = 0; i < n; i++)
+        {
+            const Point2D& a = points[i];
+            const Point2D& b = points[(i + 1) % n];
+            area += static_cast<double>(a.x) * b.y - static_cast<double>(b.x) * a.y;
+            finite = finite && std::isfinite(a.x) && std::isfinite(a.y);
+        }
+        contour.signedArea = static_cast<float>(area * 0.5);
+        contour.parent = -1;
+        contour.depth = 0;
+
+        // A single loop has nothing to nest in; NaN would break the order
+        if (!contour.closed || n < 3 || closedCount < 2 || !finite)
+            continue;
+
+        // Edge i runs from point i to i + 1: +1 up, -1 down, 0 horizontal
+        // (never crosses a horizontal ray, ends a chain)
+        auto direction = [&](size_t i)
+        {
+            float dy = points[(i + 1) % n].y - points[i].y;
+            return (dy > 0.0f) ? 1 : ((dy < 0.0f) ? -1 : 0);
+        };
+
+        // Start at an edge that begins a chain, so none wraps around
+        size_t start = n;
+        for (size_t i = 0; i < n && start == n; i++)
+        {
+            int d = direction(i);
+            if (d != 0 && d != direction((i + n - 1) % n))
+                start = i;
+        }
+        if (start == n)
+            continue;  // Flat
+
+        leftmost[c] = points[0];
+        for (size_t i = 0; i < n; i++)
+        {
+            const Point2D& a = points[i];
+            if (a.x < leftmost[c].x || (a.x == leftmost[c].x && a.y < leftmost[c].y))
+                leftmost[c] = a;
+        }
+
+        for (size_t step = 0; step < n; )
+        {
+            size_t i = (start + step) % n;
+            int d = direction(i);
+            if (d == 0)
+            {
+                step++;
+                continue;
+            }
+
+            // Longest run of edges in direction d
+            run.clear();
+            run.push_back(points[i]);
+            while (step < n && direction((start + step) % n) == d)
+            {
+                run.push_back(points[(start + step + 1) % n]);
+                step++;
+            }
+            if (d < 0)
+                std::reverse(run.begin(), run.end());
+
+            SweepChain chain;
+            chain.begin = static_cast<int>(chainX.size());
+            for (size_t k = 0; k < run.size(); k++)
+            {
+                chainX.push_back(run[k].x);
+                chainY.push_back(run[k].y);
+            }
+            chain.end = static_cast<int>(chainX.size());
+            chain.contour = c;
+            chain.goesDown = d < 0;
+
+            int id = static_cast<int>(chains.size());
+            chains.push_back(chain);
+            events.push_back({run.front().y, 1, id});
+            events.push_back({run.back().y, 0, id});
+        }
+        events.push_back({leftmost[c].y, 2, c});
+    }
+
+    if (chains.empty())
+        return;
+
+    std::sort(events.begin(), events.end());
+
+    float sweepY = events[0].y;
+    float queryX = 0.0f;
+    SweepOrder order = {&chains, &chainX, &chainY, &sweepY, &queryX};
+    typedef std::set<int, SweepOrder> ActiveSet;
+    ActiveSet active(order);
+    std::vector<ActiveSet::iterator> positions(chains.size(), active.end());
+
+    // Nearest chain to the left of each contour's leftmost vertex
+    std::vector<int> hitChain(count, -1);
+
+    for (size_t k = 0; k < events.size(); k++)
+    {
+        const SweepEvent& event = events[k];
+        sweepY = event.y;
+
+        if (event.type == 0)
+        {
+            active.erase(positions[event.index]);
+        }
+        else if (event.type == 1)
+        {
+            positions[event.index] = active.insert(event.index).first;
+        }
+        else
+        {
+            queryX = leftmost[event.index].x;
+            ActiveSet::iterator it = active.lower_bound(-1);
+            while (it != active.begin())
+            {
+                --it;
+                if (chains[*it].contour != event.index)
+                {
+                    hitChain[event.index] = *it;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Inside the hit contour if the vertex is on its inner side (the left
+    // of a counter-clockwise contour walking down, the right of a
+    // clockwise one walking up); otherwise a sibling of it
+    std::vector<int> state(count, 0);  // 0 = pending, 1 = resolving, 2 = done
+    std::vector<int> stack;
+    for (int c = 0; c < count; c++)
+    {
+        if (!contours[c].closed || contours[c].points.size() < 3)
+            state[c] = 2;
+    }
+
+    for (int c = 0; c < count; c++)
+    {
+        int current = c;
+        while (state[current] == 0)
+        {
+            state[current] = 1;
+            stack.push_back(current);
+            int e = hitChain[current];
+            if (e < 0)
+                break;
+            int hit = chains[e].contour;
+            bool inside = chains[e].goesDown == (contours[hit].signedArea > 0.0f);
+            if (inside)
+                break;
+            current = hit;  // Same parent as the hit contour: resolve it first
+        }
+
+        while (!stack.empty())
+        {
+            int q = stack.back();
+            stack.pop_back();
+
+            int parent = -1;
+            int e = hitChain[q];
+            if (e >= 0)
+            {
+                int hit = chains[e].contour;
+                bool inside = chains[e].goesDown == (contours[hit].signedArea > 0.0f);
+                if (inside)
+                    parent = hit;
+                else if (state[hit] == 2)
+                    parent = contours[hit].parent;
+                // else: inconsistent input (crossing contours), keep at the root
+            }
+
+            contours[q].parent = parent;
+            state[q] = 2;
+        }
+    }
+
+    // Depths, walking up to the first contour whose depth is known
+    std::vector<unsigned char> hasDepth(count, 0);
+    for (int c = 0; c < count; c++)
+    {
+        int current = c;
+        while (!hasDepth[current] && contours[current].parent >= 0 &&
+               stack.size() < static_cast<size_t>(count))
+        {
+            stack.push_back(current);
+            current = contours[current].parent;
+        }
+        if (!hasDepth[current])
+        {
+            contours[current].depth = 0;
+            if (contours[current].parent >= 0)
+                contours[current].parent = -1;  // Cycle from crossing contours
+            hasDepth[current] = 1;
+        }
+
+        while (!stack.empty())
+        {
+            int q = stack.back();
+            stack.pop_back();
+            int parent = contours[q].parent;
+            contours[q].depth = (parent < 0) ? 0 : contours[parent].depth + 1;
+            hasDepth[q] = 1;
+        }
+    }
+}
+
+std::vector<IsoContour> connectAllLineSegments(const std::vector<Point2D>& segments,
+                                               float epsilon)
+{
+    std::vector<IsoContour> contours;
+
+    const int segmentCount = static_cast<int>(segments.size() / 2);
+    if (segmentCount == 0)
+        return contours;
+
+    // Endpoint e belongs to segment e / 2; e ^ 1 is the other end
+    const int endpointCount = segmentCount * 2;
+    const float cellSize = (epsilon > 0.0f) ? epsilon : 1e-6f;
+    const float epsilonSq = epsilon * epsilon;
+
+    std::vector<int64_t> cellX(endpointCount), cellY(endpointCount);
+    for (int e = 0; e < endpointCount; e++)
+    {
+        cellX[e] = static_cast<int64_t>(std::floor(segments[e].x / cellSize));
+        cellY[e] = static_cast<int64_t>(std::floor(segments[e].y / cellSize));
+    }
+
+    // Hash grid, open addressing: slot -> first endpoint of a cell, the
+    // rest of the cell chained through nextInCell
+    size_t tableSize = 16;
+    while (tableSize < static_cast<size_t>(endpointCount) * 2)
+        tableSize *= 2;
+    std::vector<int> cellHead(tableSize, -1);
+    std::vector<int> nextInCell(endpointCount, -1);
+
+    auto findSlot = [&](int64_t cx, int64_t cy)
+    {
+        uint64_t hash = static_cast<uint64_t>(cx) * 73856093u ^ static_cast<uint64_t>(cy) * 19349663u;
+        size_t slot = static_cast<size_t>(hash ^ (hash >> 29)) & (tableSize - 1);
+        while (cellHead[slot] >= 0 &&
+               (cellX[cellHead[slot]] != cx || cellY[cellHead[slot]] != cy))
+        {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        return slot;
+    };
+
+    for (int e = 0; e < endpointCount; e++)
+    {
+        size_t slot = findSlot(cellX[e], cellY[e]);
+        nextInCell[e] = cellHead[slot];
+        cellHead[slot] = e;
+    }
+
+    // Pair each endpoint with the nearest free endpoint of another segment.
+    // Own cell first: Marching Squares endpoints usually match exactly, and
+    // then the neighbor cells need not be looked up.
+    static const int CELL_DX[9] = {0, -1, 0, 1, -1, 1, -1, 0, 1};
+    static const int CELL_DY[9] = {0, -1, -1, -1, 0, 0, 1, 1, 1};
+    std::vector<int> link(endpointCount, -1);
+    for (int e = 0; e < endpointCount; e++)
+    {
+        if (link[e] >= 0)
+            continue;
+
+        int best = -1;
+        float bestDistSq = epsilonSq;
+        for (int k = 0; k < 9 && !(best >= 0 && bestDistSq == 0.0f); k++)
+        {
+            size_t slot = findSlot(cellX[e] + CELL_DX[k], cellY[e] + CELL_DY[k]);
+            for (int f = cellHead[slot]; f >= 0; f = nextInCell[f])
+            {
+                if ((f >> 1) == (e >> 1) || link[f] >= 0)
+                    continue;
+                float ddx = segments[f].x - segments[e].x;
+                float ddy = segments[f].y - segments[e].y;
+                float distSq = ddx * ddx + ddy * ddy;
+                if (distSq < bestDistSq || (best < 0 && distSq == 0.0f))
+                {
+                    best = f;
+                    bestDistSq = distSq;
+                }
+            }
+        }
+
+        if (best >= 0)
+        {
+            link[e] = best;
+            link[best] = e;
+        }
+    }
+
+    // Links form disjoint paths and cycles: walk each once
+    std::vector<unsigned char> used(segmentCount, 0);
+    for (int s = 0; s < segmentCount; s++)
+    {
+        if (used[s])
+            continue;
+
+        // Back up to the free end of an open chain, if there is one
+        int start = 2 * s;
+        bool closed = false;
+        while (true)
+        {
+            int previous = link[start];
+            if (previous < 0)
+                break;
+            int previousStart = previous ^ 1;
+            if ((previousStart >> 1) == s)
+            {
+                closed = true;
+                start = 2 * s;
+                break;
+            }
+            start = previousStart;
+        }
+
+        IsoContour contour;
+        contour.closed = closed;
+        contour.points.push_back(segments[start]);
+
+        int entry = start;
+        while (true)
+        {
+            used[entry >> 1] = 1;
+            int exit = entry ^ 1;
+            int next = link[exit];
+            if (next < 0 || next == start)
+            {
+                if (next < 0)
+                    contour.points.push_back(segments[exit]);
+                break;
+            }
+            contour.points.push_back(segments[exit]);
+            entry = next;
+        }
+
+        contours.push_back(contour);
+    }
+
+    buildContourHierarchy(contours);
+    return contours;
+}
+
+/**
+ * @brief Connect line segments into an ordered closed contour
+ */
+std::vector<Point2D> connectLineSegments(const std::vector<Point2D>& segments)
+{
+    if (segments.size() < 4) // Need at least 2 line segments (4 points)
+        return std::vector<Point2D>();
+
+    // The first polyline is the one through segment 0
+    std::vector<IsoContour> contours = connectAllLineSegments(segments);
+    return contours.front().points;
+}
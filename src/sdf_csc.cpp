@@ -0,0 +1,328 @@
+#include "sdf_backends.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file sdf_csc.cpp
+ * @brief Characteristic scan-conversion backend (Mauch)
+ *
+ * Within distance r of a polygon, every point is closest either to the
+ * interior of an edge or to a vertex. The characteristic region of an edge
+ * is the slab swept by its normals (a rectangle of half-width r); the region
+ * of a vertex is the wedge between the normals of its two edges on the
+ * convex side of the turn. Together these regions cover the whole band.
+ *
+ * Each region is scan-converted and its samples receive the exact distance
+ * to the region's edges, keeping the minimum. Samples never reached keep r.
+ * Scan conversion is conservative (a half-cell strip around each sample
+ * row), so rounding can only add samples, and every value written is a
+ * distance Exact also computes. Inside the band the result therefore
+ * matches Exact bit for bit.
+ * Cost: O(E + band area in cells) plus the O(E + W*H) sign pass.
+ */
+
+/**
+ * @brief Rotate a vector counter-clockwise by an angle
+ */
+static inline Point2D rotate(const Point2D& v, float angle)
+{
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    Point2D r = {v.x * c - v.y * s, v.x * s + v.y * c};
+    return r;
+}
+
+/**
+ * @brief Append the wedge of a vertex, split into pieces of at most 90 degrees
+ *
+ * @param incoming, outgoing The two edges meeting at vertex v
+ * @param start Unit vector where the wedge starts
+ * @param angle Counter-clockwise opening angle (0, pi]
+ */
+static void addWedge(std::vector<CharacteristicRegion>& regions,
+                     int incoming, int outgoing, const Point2D& v, const Point2D& start, float angle, float r)
+{
+    const float quarterTurn = 1.5707964f;
+    int pieces = std::max(1, static_cast<int>(std::ceil(angle / quarterTurn)));
+    float pieceAngle = angle / pieces;
+    float bisectorLength = r / std::cos(0.5f * pieceAngle);
+
+    for (int j = 0; j < pieces; j++)
+    {
+        Point2D e0 = rotate(start, j * pieceAngle);
+        Point2D e1 = rotate(start, (j + 1) * pieceAngle);
+        Point2D m = rotate(start, (j + 0.5f) * pieceAngle);
+
+        CharacteristicRegion region;
+        region.corners[0] = v;
+        region.corners[1] = {v.x + e0.x * r, v.y + e0.y * r};
+        region.corners[2] = {v.x + m.x * bisectorLength, v.y + m.y * bisectorLength};
+        region.corners[3] = {v.x + e1.x * r, v.y + e1.y * r};
+        region.edges[0] = incoming;
+        region.edges[1] = outgoing;
+        regions.push_back(region);
+    }
+}
+
+/**
+ * @brief Build the slab and wedge regions of every edge and vertex
+ */
+static void buildCharacteristicRegions(const PreparedPolygon& prepared, float r,
+                                       std::vector<CharacteristicRegion>& regions)
+{
+    const int n = prepared.edgeCount;
+    regions.reserve(n * 2);
+
+    for (int i = 0; i < n; i++)
+    {
+        float dx = prepared.dirX[i];
+        float dy = prepared.dirY[i];
+        if (prepared.invLengthSq[i] == 0.0f)
+            continue;  // Degenerate edge: its end vertices cover it
+
+        float scale = r * std::sqrt(prepared.invLengthSq[i]);
+        Point2D normal = {dy * scale, -dx * scale};
+        Point2D a = {prepared.originX[i], prepared.originY[i]};
+        Point2D b = {a.x + dx, a.y + dy};
+
+        CharacteristicRegion slab;
+        slab.corners[0] = {a.x + normal.x, a.y + normal.y};
+        slab.corners[1] = {b.x + normal.x, b.y + normal.y};
+        slab.corners[2] = {b.x - normal.x, b.y - normal.y};
+        slab.corners[3] = {a.x - normal.x, a.y - normal.y};
+        slab.edges[0] = i;
+        slab.edges[1] = i;
+        regions.push_back(slab);
+    }
+
+    // Vertex i is the start of edge i and the end of edge i - 1. Degenerate
+    // edges are skipped so that the two directions are well defined.
+    for (int i = 0; i < n; i++)
+    {
+        Point2D v = {prepared.originX[i], prepared.originY[i]};
+
+        int incoming = (i == 0) ? n - 1 : i - 1;
+        int steps = 0;
+        while (prepared.invLengthSq[incoming] == 0.0f && steps++ < n)
+            incoming = (incoming == 0) ? n - 1 : incoming - 1;
+
+        int outgoing = i;
+        steps = 0;
+        while (prepared.invLengthSq[outgoing] == 0.0f && steps++ < n)
+            outgoing = (outgoing == n - 1) ? 0 : outgoing + 1;
+
+        if (prepared.invLengthSq[incoming] == 0.0f || prepared.invLengthSq[outgoing] == 0.0f)
+        {
+            // Every edge is degenerate: the whole disc belongs to the vertex
+            addWedge(regions, i, i, v, Point2D{1.0f, 0.0f}, 3.1415927f, r);
+            addWedge(regions, i, i, v, Point2D{-1.0f, 0.0f}, 3.1415927f, r);
+            continue;
+        }
+
+        float s1 = std::sqrt(prepared.invLengthSq[incoming]);
+        float s2 = std::sqrt(prepared.invLengthSq[outgoing]);
+        Point2D d1 = {prepared.dirX[incoming] * s1, prepared.dirY[incoming] * s1};
+        Point2D d2 = {prepared.dirX[outgoing] * s2, prepared.dirY[outgoing] * s2};
+
+        float turn = d1.x * d2.y - d1.y * d2.x;
+        float along = d1.x * d2.x + d1.y * d2.y;
+        float angle = std::atan2(std::fabs(turn), along);
+        if (angle <= 0.0f)
+            continue;  // Straight continuation: the slabs meet exactly
+
+        // The wedge lies on the outer side of the turn, between the normals
+        if (turn >= 0.0f)
+            addWedge(regions, incoming, outgoing, v, Point2D{d1.y, -d1.x}, angle, r);   // From right normal of d1
+        else
+            addWedge(regions, incoming, outgoing, v, Point2D{-d2.y, d2.x}, angle, r);   // From left normal of d2
+    }
+}
+
+/**
+ * @brief x-extent of a convex quad inside the horizontal strip [y0, y1]
+ *
+ * @return false if the quad does not reach the strip
+ */
+static bool quadStripExtent(const Point2D* corners, float y0, float y1,
+                            float& outMinX, float& outMaxX)
+{
+    bool found = false;
+    outMinX = outMaxX = 0.0f;
+
+    for (int k = 0; k < 4; k++)
+    {
+        const Point2D& p = corners[k];
+        const Point2D& q = corners[(k + 1) & 3];
+
+        // Clip the quad edge pq to the strip
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        float dy = q.y - p.y;
+        if (dy == 0.0f)
+        {
+            if (p.y < y0 || p.y > y1)
+                continue;
+        }
+        else
+        {
+            float ta = (y0 - p.y) / dy;
+            float tb = (y1 - p.y) / dy;
+            tMin = std::max(tMin, std::min(ta, tb));
+            tMax = std::min(tMax, std::max(ta, tb));
+            if (tMin > tMax)
+                continue;
+        }
+
+        float xa = p.x + (q.x - p.x) * tMin;
+        float xb = p.x + (q.x - p.x) * tMax;
+        if (!found)
+        {
+            outMinX = std::min(xa, xb);
+            outMaxX = std::max(xa, xb);
+            found = true;
+        }
+        else
+        {
+            outMinX = std::min(outMinX, std::min(xa, xb));
+            outMaxX = std::max(outMaxX, std::max(xa, xb));
+        }
+    }
+
+    return found;
+}
+
+CharacteristicBands::CharacteristicBands(int width, int height,
+                                         float worldMinX, float worldMaxX,
+                                         float worldMinY, float worldMaxY,
+                                         const PreparedPolygon& prepared,
+                                         float maxDistance, int rowsPerBand)
+    : m_prepared(prepared)
+    , m_width(width)
+    , m_height(height)
+    , m_worldMinX(worldMinX)
+    , m_worldMinY(worldMinY)
+    , m_stepX((worldMaxX - worldMinX) / width)
+    , m_stepY((worldMaxY - worldMinY) / height)
+    , m_maxDistance(maxDistance)
+    , m_rowsPerBand(std::max(1, rowsPerBand))
+    , m_bandCount((height + m_rowsPerBand - 1) / m_rowsPerBand)
+{
+    buildCharacteristicRegions(prepared, maxDistance, m_regions);
+
+    // Bucket regions by row band so that bands can be filled in parallel
+    m_regionRowBegin.resize(m_regions.size());
+    m_regionRowEnd.resize(m_regions.size());
+    m_bandStart.assign(m_bandCount + 1, 0);
+
+    for (size_t k = 0; k < m_regions.size(); k++)
+    {
+        float minY = m_regions[k].corners[0].y;
+        float maxY = minY;
+        for (int c = 1; c < 4; c++)
+        {
+            minY = std::min(minY, m_regions[k].corners[c].y);
+            maxY = std::max(maxY, m_regions[k].corners[c].y);
+        }
+
+        // Rows whose half-cell strip touches [minY, maxY]
+        float rowMin = std::ceil((minY - worldMinY) / m_stepY - 1.0f);
+        float rowMax = std::floor((maxY - worldMinY) / m_stepY);
+        m_regionRowBegin[k] = static_cast<int>(std::max(0.0f, std::min(rowMin, static_cast<float>(height))));
+        m_regionRowEnd[k] = static_cast<int>(std::max(0.0f, std::min(rowMax + 1.0f, static_cast<float>(height))));
+
+        if (m_regionRowBegin[k] < m_regionRowEnd[k])
+        {
+            for (int band = m_regionRowBegin[k] / m_rowsPerBand; band <= (m_regionRowEnd[k] - 1) / m_rowsPerBand; band++)
+                m_bandStart[band + 1]++;
+        }
+    }
+
+    for (int band = 0; band < m_bandCount; band++)
+        m_bandStart[band + 1] += m_bandStart[band];
+
+    m_bandRegions.resize(m_bandStart[m_bandCount]);
+    std::vector<int> fill(m_bandStart.begin(), m_bandStart.end() - 1);
+    for (size_t k = 0; k < m_regions.size(); k++)
+    {
+        if (m_regionRowBegin[k] < m_regionRowEnd[k])
+        {
+            for (int band = m_regionRowBegin[k] / m_rowsPerBand; band <= (m_regionRowEnd[k] - 1) / m_rowsPerBand; band++)
+                m_bandRegions[fill[band]++] = static_cast<int>(k);
+        }
+    }
+}
+
+void CharacteristicBands::fillBand(int band, float* rows) const
+{
+    const int bandBegin = band * m_rowsPerBand;
+    const int bandEnd = std::min(m_height, bandBegin + m_rowsPerBand);
+    std::fill(rows, rows + (bandEnd - bandBegin) * m_width, m_maxDistance);
+
+    for (int j = m_bandStart[band]; j < m_bandStart[band + 1]; j++)
+    {
+        const CharacteristicRegion& region = m_regions[m_bandRegions[j]];
+        const int rowBegin = std::max(bandBegin, m_regionRowBegin[m_bandRegions[j]]);
+        const int rowEnd = std::min(bandEnd, m_regionRowEnd[m_bandRegions[j]]);
+
+        for (int y = rowBegin; y < rowEnd; y++)
+        {
+            const float py = m_worldMinY + (y + 0.5f) * m_stepY;
+            float minX, maxX;
+            if (!quadStripExtent(region.corners, py - 0.5f * m_stepY, py + 0.5f * m_stepY, minX, maxX))
+                continue;
+
+            int xBegin = static_cast<int>(std::max(0.0f, std::ceil((minX - m_worldMinX) / m_stepX - 1.0f)));
+            int xEnd = static_cast<int>(std::min(static_cast<float>(m_width), std::floor((maxX - m_worldMinX) / m_stepX) + 1.0f));
+
+            float* row = rows + (y - bandBegin) * m_width;
+            for (int x = xBegin; x < xEnd; x++)
+            {
+                float px = m_worldMinX + (x + 0.5f) * m_stepX;
+                float dist = std::min(preparedEdgeDistance(m_prepared, region.edges[0], px, py),
+                                      preparedEdgeDistance(m_prepared, region.edges[1], px, py));
+
+                row[x] = std::min(row[x], dist);
+            }
+        }
+    }
+}
+
+bool generateSDFGridCSC(int width, int height,
+                        float worldMinX, float worldMaxX,
+                        float worldMinY, float worldMaxY,
+                        const PreparedPolygon& prepared,
+                        float maxDistance,
+                        float* sdfData,
+                        int threadCount)
+{
+    const float stepX = (worldMaxX - worldMinX) / width;
+    const float stepY = (worldMaxY - worldMinY) / height;
+    if (!(stepX > 0.0f) || !(stepY > 0.0f) || !(maxDistance > 0.0f) || prepared.edgeCount < 3)
+        return false;
+
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+    const int rowsPerBand = std::max(1, height / (threads * 4));
+    CharacteristicBands bands(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                              prepared, maxDistance, rowsPerBand);
+
+    std::vector<unsigned char> insideMask(width * height);
+    computeInsideMask(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                      prepared, insideMask.data(), threadCount);
+
+    ThreadPool::shared().parallelFor(bands.getBandCount(), threads, [&](int band)
+    {
+        const int bandBegin = band * rowsPerBand;
+        const int bandEnd = std::min(height, bandBegin + rowsPerBand);
+        bands.fillBand(band, sdfData + bandBegin * width);
+
+        // Apply the sign
+        for (int index = bandBegin * width; index < bandEnd * width; index++)
+        {
+            if (insideMask[index])
+                sdfData[index] = -sdfData[index];
+        }
+    });
+
+    return true;
+}
@@ -0,0 +1,197 @@
+#include "sdf_backends.h"
+#include "EdgeBVH.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/**
+ * @file sdf_incremental.cpp
+ * @brief Partial refresh of a dense Exact grid after some edges changed
+ *
+ * A sample can only change if
+ * - its nearest edge was one of the old edges (stored |d| >= distance to
+ *   them): the distance is recomputed through the edge index;
+ * - one of the new edges is nearer than the stored distance: the minimum
+ *   of the stored value and the new edges is taken;
+ * - it lies in the region swept by the edit: the sign is recomputed.
+ * Every other sample keeps its value. Tiles are culled against the box of
+ * the changed geometry and the largest stored |d| in the tile.
+ */
+
+/**
+ * @brief Is p inside triangle (a, b, c) or within tolerance of it?
+ *
+ * Either orientation; zero-length sides do not constrain.
+ */
+static bool nearTriangle(float px, float py, const Point2D* tri, float tolerance)
+{
+    float area = (tri[1].x - tri[0].x) * (tri[2].y - tri[0].y) -
+                 (tri[1].y - tri[0].y) * (tri[2].x - tri[0].x);
+    float orientation = (area < 0.0f) ? -1.0f : 1.0f;
+
+    for (int k = 0; k < 3; k++)
+    {
+        const Point2D& a = tri[k];
+        const Point2D& b = tri[(k + 1) % 3];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length == 0.0f)
+            continue;
+
+        // Signed distance to the side's line, positive towards the interior
+        float side = orientation * (dx * (py - a.y) - dy * (px - a.x)) / length;
+        if (side < -tolerance)
+            return false;
+    }
+    return true;
+}
+
+int updateSDFGridEdges(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const PreparedPolygon& oldEdges,
+                       const PreparedPolygon& newEdges,
+                       const Point2D* sweptTriangles, int triangleCount,
+                       const EdgeBVH& index,
+                       int tileSize,
+                       float* sdfData,
+                       std::vector<unsigned char>& changedTiles,
+                       int threadCount)
+{
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+    changedTiles.assign(tilesX * tilesY, 0);
+
+    const float stepX = (worldMaxX - worldMinX) / width;
+    const float stepY = (worldMaxY - worldMinY) / height;
+    const float tolerance = 1e-3f * std::max(stepX, stepY);
+
+    // Boxes of the changed edges and of the swept region
+    float edgeMinX = std::numeric_limits<float>::max(), edgeMaxX = -edgeMinX;
+    float edgeMinY = edgeMinX, edgeMaxY = -edgeMinX;
+    const PreparedPolygon* edgeSets[2] = {&oldEdges, &newEdges};
+    for (int s = 0; s < 2; s++)
+    {
+        const PreparedPolygon& edges = *edgeSets[s];
+        for (int i = 0; i < edges.edgeCount; i++)
+        {
+            float x0 = edges.originX[i];
+            float x1 = edges.originX[i] + edges.dirX[i];
+            edgeMinX = std::min(edgeMinX, std::min(x0, x1));
+            edgeMaxX = std::max(edgeMaxX, std::max(x0, x1));
+            edgeMinY = std::min(edgeMinY, edges.minY[i]);
+            edgeMaxY = std::max(edgeMaxY, edges.maxY[i]);
+        }
+    }
+
+    float sweptMinX = std::numeric_limits<float>::max(), sweptMaxX = -sweptMinX;
+    float sweptMinY = sweptMinX, sweptMaxY = -sweptMinX;
+    for (int k = 0; k < triangleCount * 3; k++)
+    {
+        sweptMinX = std::min(sweptMinX, sweptTriangles[k].x - tolerance);
+        sweptMaxX = std::max(sweptMaxX, sweptTriangles[k].x + tolerance);
+        sweptMinY = std::min(sweptMinY, sweptTriangles[k].y - tolerance);
+        sweptMaxY = std::max(sweptMaxY, sweptTriangles[k].y + tolerance);
+    }
+
+    std::vector<int> changedCounts(changedTiles.size(), 0);
+    const int threads = ThreadPool::resolveThreadCount(threadCount);
+
+    ThreadPool::shared().parallelFor(tilesX * tilesY, threads, [&](int tile)
+    {
+        const int x0 = (tile % tilesX) * tileSize;
+        const int y0 = (tile / tilesX) * tileSize;
+        const int x1 = std::min(width, x0 + tileSize);
+        const int y1 = std::min(height, y0 + tileSize);
+
+        // Sample-center box of the tile
+        const float tileMinX = worldMinX + (x0 + 0.5f) * stepX;
+        const float tileMaxX = worldMinX + (x1 - 0.5f) * stepX;
+        const float tileMinY = worldMinY + (y0 + 0.5f) * stepY;
+        const float tileMaxY = worldMinY + (y1 - 0.5f) * stepY;
+
+        bool touchesSwept = !(tileMaxX < sweptMinX || tileMinX > sweptMaxX ||
+                              tileMaxY < sweptMinY || tileMinY > sweptMaxY);
+        if (!touchesSwept)
+        {
+            float maxAbs = 0.0f;
+            for (int y = y0; y < y1; y++)
+            {
+                const float* row = sdfData + y * width;
+                for (int x = x0; x < x1; x++)
+                    maxAbs = std::max(maxAbs, std::fabs(row[x]));
+            }
+
+            float dx = std::max(std::max(edgeMinX - tileMaxX, tileMinX - edgeMaxX), 0.0f);
+            float dy = std::max(std::max(edgeMinY - tileMaxY, tileMinY - edgeMaxY), 0.0f);
+            if (std::sqrt(dx * dx + dy * dy) > maxAbs * (1.0f + 1e-5f) + tolerance)
+                return;  // Every changed edge is farther than every stored distance
+        }
+
+        int changed = 0;
+        for (int y = y0; y < y1; y++)
+        {
+            float py = worldMinY + (y + 0.5f) * stepY;
+            float* row = sdfData + y * width;
+            for (int x = x0; x < x1; x++)
+            {
+                float px = worldMinX + (x + 0.5f) * stepX;
+                float stored = row[x];
+                float storedAbs = std::fabs(stored);
+
+                bool inSweptBox = touchesSwept &&
+                                  px >= sweptMinX && px <= sweptMaxX &&
+                                  py >= sweptMinY && py <= sweptMaxY;
+                if (!inSweptBox)
+                {
+                    // Cheap reject against the box of the changed edges
+                    float dx = std::max(std::max(edgeMinX - px, px - edgeMaxX), 0.0f);
+                    float dy = std::max(std::max(edgeMinY - py, py - edgeMaxY), 0.0f);
+                    if (dx * dx + dy * dy > storedAbs * storedAbs * (1.0f + 1e-5f) + tolerance * tolerance)
+                        continue;
+                }
+
+                float oldDist = std::numeric_limits<float>::max();
+                for (int i = 0; i < oldEdges.edgeCount; i++)
+                    oldDist = std::min(oldDist, preparedEdgeDistance(oldEdges, i, px, py));
+                float newDist = std::numeric_limits<float>::max();
+                for (int i = 0; i < newEdges.edgeCount; i++)
+                    newDist = std::min(newDist, preparedEdgeDistance(newEdges, i, px, py));
+
+                bool swept = false;
+                if (inSweptBox)
+                {
+                    for (int t = 0; t < triangleCount && !swept; t++)
+                        swept = nearTriangle(px, py, sweptTriangles + t * 3, tolerance);
+                }
+
+                if (oldDist > storedAbs && newDist >= storedAbs && !swept)
+                    continue;
+
+                Point2D p = {px, py};
+                // The nearest edge was an unchanged one if the old edges are
+                // farther, and unchanged edges did not move
+                float dist = (oldDist > storedAbs) ? std::min(storedAbs, newDist) : index.distance(p);
+                bool inside = swept ? index.isInside(p) : std::signbit(stored);
+                float value = inside ? -dist : dist;
+
+                if (std::memcmp(&value, &stored, sizeof(float)) != 0)
+                {
+                    row[x] = value;
+                    changed++;
+                }
+            }
+        }
+
+        changedCounts[tile] = changed;
+        changedTiles[tile] = (changed > 0) ? 1 : 0;
+    });
+
+    int total = 0;
+    for (size_t t = 0; t < changedCounts.size(); t++)
+        total += changedCounts[t];
+    return total;
+}
@@ -0,0 +1,177 @@
+#include "sdf_backends.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Does edge i add to the winding number of the sample at px?
+ *
+ * Same predicate as the winding test of calculatePreparedSDF(). For a fixed
+ * row it holds for a prefix of the samples (cross is monotonic in px).
+ */
+static inline bool edgeCountsSample(const PreparedPolygon& prepared, int i,
+                                    float px, float pay)
+{
+    float pax = px - prepared.originX[i];
+    float cross = prepared.dirX[i] * pay - pax * prepared.dirY[i];
+    return (prepared.dirY[i] > 0) ? (cross > 0) : (cross < 0);
+}
+
+/**
+ * @brief First index in [0, count] whose sample coordinate is >= value
+ *
+ * The estimate is refined against the exact float sample positions.
+ */
+static int firstSampleAtOrAbove(float value, float origin, float step, int count)
+{
+    float estimate = std::ceil((value - origin) / step - 0.5f);
+    int index = !(estimate > 0.0f) ? 0 :
+                (estimate > static_cast<float>(count)) ? count : static_cast<int>(estimate);
+
+    while (index > 0 && origin + (index - 1 + 0.5f) * step >= value)
+        index--;
+    while (index < count && origin + (index + 0.5f) * step < value)
+        index++;
+    return index;
+}
+
+ScanlineRows::ScanlineRows(int width, int height,
+                           float worldMinX, float worldMaxX,
+                           float worldMinY, float worldMaxY,
+                           const PreparedPolygon& prepared)
+    : m_prepared(prepared)
+    , m_width(width)
+    , m_worldMinX(worldMinX)
+    , m_worldMinY(worldMinY)
+    , m_stepX((worldMaxX - worldMinX) / width)
+    , m_stepY((worldMaxY - worldMinY) / height)
+{
+    if (width <= 0 || height <= 0 || !(m_stepX > 0.0f) || !(m_stepY > 0.0f) ||
+        prepared.edgeCount < 3)
+    {
+        return;
+    }
+
+    // Bucket edges by the rows they cross (counting sort into CSR arrays).
+    // Edge i crosses row y when minY <= py < maxY.
+    std::vector<int> firstRow(prepared.edgeCount);
+    std::vector<int> lastRow(prepared.edgeCount);
+    m_rowStart.assign(height + 1, 0);
+
+    for (int i = 0; i < prepared.edgeCount; i++)
+    {
+        firstRow[i] = firstSampleAtOrAbove(prepared.minY[i], worldMinY, m_stepY, height);
+        lastRow[i] = firstSampleAtOrAbove(prepared.maxY[i], worldMinY, m_stepY, height);
+        for (int y = firstRow[i]; y < lastRow[i]; y++)
+            m_rowStart[y + 1]++;
+    }
+
+    for (int y = 0; y < height; y++)
+        m_rowStart[y + 1] += m_rowStart[y];
+
+    m_rowEdges.resize(m_rowStart[height]);
+    std::vector<int> fill(m_rowStart.begin(), m_rowStart.end() - 1);
+    for (int i = 0; i < prepared.edgeCount; i++)
+    {
+        for (int y = firstRow[i]; y < lastRow[i]; y++)
+            m_rowEdges[fill[y]++] = i;
+    }
+}
+
+void ScanlineRows::classifyRow(int y, std::vector<int>& delta, unsigned char* row) const
+{
+    if (m_rowStart.empty() || m_rowStart[y] == m_rowStart[y + 1])
+    {
+        // No crossings: the whole row is outside
+        std::fill(row, row + m_width, 0);
+        return;
+    }
+
+    delta.assign(m_width + 1, 0);
+    const float py = m_worldMinY + (y + 0.5f) * m_stepY;
+
+    // Each crossing edge counts the samples left of it: [0, k)
+    for (int j = m_rowStart[y]; j < m_rowStart[y + 1]; j++)
+    {
+        int i = m_rowEdges[j];
+        float pay = py - m_prepared.originY[i];
+        float crossX = m_prepared.originX[i] + m_prepared.dirX[i] * pay / m_prepared.dirY[i];
+
+        int k = firstSampleAtOrAbove(crossX, m_worldMinX, m_stepX, m_width);
+        while (k > 0 && !edgeCountsSample(m_prepared, i, m_worldMinX + (k - 1 + 0.5f) * m_stepX, pay))
+            k--;
+        while (k < m_width && edgeCountsSample(m_prepared, i, m_worldMinX + (k + 0.5f) * m_stepX, pay))
+            k++;
+
+        int direction = (m_prepared.dirY[i] > 0) ? 1 : -1;
+        delta[0] += direction;
+        delta[k] -= direction;
+    }
+
+    // Nonzero winding rule over the prefix sums
+    int winding = 0;
+    for (int x = 0; x < m_width; x++)
+    {
+        winding += delta[x];
+        row[x] = (winding != 0) ? 1 : 0;
+    }
+}
+
+void computeInsideMask(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const PreparedPolygon& prepared,
+                       unsigned char* insideMask,
+                       int threadCount)
+{
+    if (insideMask == nullptr || width <= 0 || height <= 0)
+        return;
+
+    std::fill(insideMask, insideMask + width * height, 0);
+    if (prepared.edgeCount < 3)
+        return;
+
+    const float stepX = (worldMaxX - worldMinX) / width;
+    const float stepY = (worldMaxY - worldMinY) / height;
+
+    if (!(stepX > 0.0f) || !(stepY > 0.0f))
+    {
+        // Degenerate extent: classify sample by sample
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                Point2D p = {worldMinX + (x + 0.5f) * stepX, worldMinY + (y + 0.5f) * stepY};
+                insideMask[y * width + x] = calculatePreparedSDF(p, prepared) < 0.0f ? 1 : 0;
+            }
+        }
+        return;
+    }
+
+    ScanlineRows rows(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY, prepared);
+
+    int threads = ThreadPool::resolveThreadCount(threadCount);
+    const int rowsPerBand = std::max(1, height / (threads * 4));
+    const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+
+    ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+    {
+        std::vector<int> delta;
+        int rowEnd = std::min(height, (band + 1) * rowsPerBand);
+        for (int y = band * rowsPerBand; y < rowEnd; y++)
+            rows.classifyRow(y, delta, insideMask + y * width);
+    });
+}
+
+void computeInsideMask(int width, int height,
+                       float worldMinX, float worldMaxX,
+                       float worldMinY, float worldMaxY,
+                       const std::vector<Point2D>& polygon,
+                       unsigned char* insideMask,
+                       int threadCount)
+{
+    PreparedPolygon prepared;
+    preparePolygon(polygon, prepared);
+    computeInsideMask(width, height, worldMinX, worldMaxX, worldMinY, worldMaxY,
+                      prepared, insideMask, threadCount);
+}
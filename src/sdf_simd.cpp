@@ -0,0 +1,1033 @@
+#include "sdf_simd.h"
+#include "sdf_backends.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// x86 SIMD support. SSE2 is the baseline on x86-64; AVX2 and AVX-512 kernels
+// are compiled with per-function target attributes and picked at runtime.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SDF_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if SDF_HAVE_SSE2 && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define SDF_HAVE_AVX 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SDF_TARGET_AVX2
+#define SDF_TARGET_AVX512
+#else
+#define SDF_TARGET_AVX2 __attribute__((target("avx2")))
+#define SDF_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+/**
+ * @brief Unsigned distance with the same float operations as
+ *        calculatePreparedSDF(), without the winding test
+ */
+static float preparedDistance(const Point2D& p, const PreparedPolygon& e)
+{
+    float minDistSq = FLT_MAX;
+    for (int i = 0; i < e.edgeCount; i++)
+    {
+        float pax = p.x - e.originX[i];
+        float pay = p.y - e.originY[i];
+        float t = clamp((pax * e.dirX[i] + pay * e.dirY[i]) * e.invLengthSq[i], 0.0f, 1.0f);
+        float ex = pax - e.dirX[i] * t;
+        float ey = pay - e.dirY[i] * t;
+        minDistSq = std::min(minDistSq, ex * ex + ey * ey);
+    }
+    return std::sqrt(minDistSq);
+}
+
+static inline float signedByMask(float dist, unsigned char inside)
+{
+    return inside ? -dist : dist;
+}
+
+/**
+ * @brief Negate the stored distances of inside pixels
+ */
+static inline void applyMaskSigns(float* out, const unsigned char* insideRow, int count)
+{
+    for (int k = 0; k < count; k++)
+        out[k] = signedByMask(out[k], insideRow[k]);
+}
+
+void computeSDFRowScalar(const PreparedPolygon& prepared,
+                         float originX, float stepX, float py,
+                         int width, float* out,
+                         const unsigned char* insideRow)
+{
+    for (int x = 0; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        out[x] = (insideRow == nullptr) ? calculatePreparedSDF(p, prepared)
+                                        : signedByMask(preparedDistance(p, prepared), insideRow[x]);
+    }
+}
+
+/**
+ * @brief Store the distance and gradient of one sample
+ */
+static inline void storeGradientSample(const PreparedPolygon& prepared, const Point2D& p,
+                                       float* distance, float* gradient)
+{
+    Point2D g;
+    *distance = calculatePreparedSDFGradient(p, prepared, g);
+    gradient[0] = g.x;
+    gradient[1] = g.y;
+}
+
+/**
+ * @brief Store a block of samples from their nearest edge offsets
+ *
+ * Mirrors the end of calculatePreparedSDFGradient(). Samples that may be on
+ * the boundary for their nearest edge (within isOnBoundary() of the widest
+ * edge, maxExtent) need the edge normal and go through the scalar path.
+ */
+static void storeGradientBlock(const PreparedPolygon& prepared, float maxExtent,
+                               float originX, float stepX, float py, int x, int count,
+                               const float* dist, const float* nearestX, const float* nearestY,
+                               const int* winding,
+                               float* distances, int distanceStride,
+                               float* gradients, int gradientStride)
+{
+    for (int k = 0; k < count; k++)
+    {
+        float* distance = distances + (x + k) * distanceStride;
+        float* gradient = gradients + (x + k) * gradientStride;
+        Point2D p = {originX + (x + k + 0.5f) * stepX, py};
+        if (!isOnBoundary(p, dist[k], maxExtent))
+        {
+            Point2D g = offsetGradient(nearestX[k], nearestY[k], dist[k], winding[k] != 0);
+            *distance = winding[k] != 0 ? -dist[k] : dist[k];
+            gradient[0] = g.x;
+            gradient[1] = g.y;
+        }
+        else
+        {
+            storeGradientSample(prepared, p, distance, gradient);
+        }
+    }
+}
+
+/**
+ * @brief Largest |dx| + |dy| over the edges
+ */
+static float maxEdgeExtent(const PreparedPolygon& prepared)
+{
+    float extent = 0.0f;
+    for (int i = 0; i < prepared.edgeCount; i++)
+        extent = std::max(extent, std::fabs(prepared.dirX[i]) + std::fabs(prepared.dirY[i]));
+    return extent;
+}
+
+void computeSDFGradientRowScalar(const PreparedPolygon& prepared,
+                                 float originX, float stepX, float py, int width,
+                                 float* distances, int distanceStride,
+                                 float* gradients, int gradientStride)
+{
+    for (int x = 0; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        storeGradientSample(prepared, p, distances + x * distanceStride,
+                            gradients + x * gradientStride);
+    }
+}
+
+void computeSDFPointsScalar(const PreparedPolygon& prepared,
+                            const float* xs, const float* ys,
+                            int count, float* out)
+{
+    for (int k = 0; k < count; k++)
+    {
+        Point2D p = {xs[k], ys[k]};
+        out[k] = calculatePreparedSDF(p, prepared);
+    }
+}
+
+void unpackSDFCodes8Scalar(const unsigned char* codes, int count,
+                           float scale, float offset, float* out)
+{
+    for (int k = 0; k < count; k++)
+        out[k] = static_cast<float>(codes[k]) * scale + offset;
+}
+
+void unpackSDFCodes16Scalar(const unsigned short* codes, int count,
+                            float scale, float offset, float* out)
+{
+    for (int k = 0; k < count; k++)
+        out[k] = static_cast<float>(codes[k]) * scale + offset;
+}
+
+#if SDF_HAVE_SSE2
+/**
+ * @brief SSE2 row kernel, 4 pixels per edge step
+ */
+static void computeSDFRowSSE2(const PreparedPolygon& e,
+                              float originX, float stepX, float py,
+                              int width, float* out,
+                              const unsigned char* insideRow)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 laneOffset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+
+    const bool needWinding = (insideRow == nullptr);
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128 px = _mm_add_ps(_mm_set1_ps(originX),
+            _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset),
+                       _mm_set1_ps(stepX)));
+        __m128 minD2 = _mm_set1_ps(FLT_MAX);
+        __m128i winding = _mm_setzero_si128();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m128 dx = _mm_set1_ps(e.dirX[i]);
+            __m128 dy = _mm_set1_ps(e.dirY[i]);
+            __m128 pax = _mm_sub_ps(px, _mm_set1_ps(e.originX[i]));
+
+            __m128 t = _mm_mul_ps(
+                _mm_add_ps(_mm_mul_ps(pax, dx), _mm_set1_ps(payScalar * e.dirY[i])),
+                _mm_set1_ps(e.invLengthSq[i]));
+            t = _mm_min_ps(_mm_max_ps(t, zero), one);
+            __m128 ex = _mm_sub_ps(pax, _mm_mul_ps(dx, t));
+            __m128 ey = _mm_sub_ps(_mm_set1_ps(payScalar), _mm_mul_ps(dy, t));
+            minD2 = _mm_min_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), minD2);
+
+            // Winding: whether and how the edge crosses is uniform along the row
+            // (skipped when the caller provides the signs)
+            if (needWinding && py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m128 cross = _mm_sub_ps(_mm_set1_ps(e.dirX[i] * payScalar),
+                                          _mm_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm_sub_epi32(winding, _mm_castps_si128(_mm_cmpgt_ps(cross, zero)));
+                else
+                    winding = _mm_add_epi32(winding, _mm_castps_si128(_mm_cmplt_ps(cross, zero)));
+            }
+        }
+
+        __m128 dist = _mm_sqrt_ps(minD2);
+        if (needWinding)
+        {
+            __m128 outside = _mm_castsi128_ps(_mm_cmpeq_epi32(winding, _mm_setzero_si128()));
+            _mm_storeu_ps(out + x, _mm_xor_ps(dist, _mm_andnot_ps(outside, signBit)));
+        }
+        else
+        {
+            _mm_storeu_ps(out + x, dist);
+            applyMaskSigns(out + x, insideRow + x, 4);
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        out[x] = needWinding ? calculatePreparedSDF(p, e)
+                             : signedByMask(preparedDistance(p, e), insideRow[x]);
+    }
+}
+
+/**
+ * @brief SSE2 gradient row kernel, 4 pixels per edge step
+ *
+ * Like computeSDFRowSSE2(), plus the offset to the nearest edge per lane,
+ * replaced whenever an edge is strictly closer.
+ */
+static void computeSDFGradientRowSSE2(const PreparedPolygon& e,
+                                      float originX, float stepX, float py, int width,
+                                      float* distances, int distanceStride,
+                                      float* gradients, int gradientStride)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 laneOffset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const float maxExtent = maxEdgeExtent(e);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128 px = _mm_add_ps(_mm_set1_ps(originX),
+            _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset),
+                       _mm_set1_ps(stepX)));
+        __m128 minD2 = _mm_set1_ps(FLT_MAX);
+        __m128 nearestX = zero;
+        __m128 nearestY = zero;
+        __m128i winding = _mm_setzero_si128();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m128 dx = _mm_set1_ps(e.dirX[i]);
+            __m128 dy = _mm_set1_ps(e.dirY[i]);
+            __m128 pax = _mm_sub_ps(px, _mm_set1_ps(e.originX[i]));
+
+            __m128 t = _mm_mul_ps(
+                _mm_add_ps(_mm_mul_ps(pax, dx), _mm_set1_ps(payScalar * e.dirY[i])),
+                _mm_set1_ps(e.invLengthSq[i]));
+            t = _mm_min_ps(_mm_max_ps(t, zero), one);
+            __m128 ex = _mm_sub_ps(pax, _mm_mul_ps(dx, t));
+            __m128 ey = _mm_sub_ps(_mm_set1_ps(payScalar), _mm_mul_ps(dy, t));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+            __m128 closer = _mm_cmplt_ps(d2, minD2);
+            minD2 = _mm_min_ps(d2, minD2);
+            nearestX = _mm_or_ps(_mm_and_ps(closer, ex), _mm_andnot_ps(closer, nearestX));
+            nearestY = _mm_or_ps(_mm_and_ps(closer, ey), _mm_andnot_ps(closer, nearestY));
+
+            if (py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m128 cross = _mm_sub_ps(_mm_set1_ps(e.dirX[i] * payScalar),
+                                          _mm_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm_sub_epi32(winding, _mm_castps_si128(_mm_cmpgt_ps(cross, zero)));
+                else
+                    winding = _mm_add_epi32(winding, _mm_castps_si128(_mm_cmplt_ps(cross, zero)));
+            }
+        }
+
+        float dist[4], offsetX[4], offsetY[4];
+        int laneWinding[4];
+        _mm_storeu_ps(dist, _mm_sqrt_ps(minD2));
+        _mm_storeu_ps(offsetX, nearestX);
+        _mm_storeu_ps(offsetY, nearestY);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(laneWinding), winding);
+        storeGradientBlock(e, maxExtent, originX, stepX, py, x, 4, dist, offsetX, offsetY, laneWinding,
+                           distances, distanceStride, gradients, gradientStride);
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        storeGradientSample(e, p, distances + x * distanceStride, gradients + x * gradientStride);
+    }
+}
+
+/**
+ * @brief SSE2 points kernel, 4 points per edge step
+ */
+static void computeSDFPointsSSE2(const PreparedPolygon& e,
+                                 const float* xs, const float* ys,
+                                 int count, float* out)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    int k = 0;
+    for (; k + 4 <= count; k += 4)
+    {
+        __m128 px = _mm_loadu_ps(xs + k);
+        __m128 py = _mm_loadu_ps(ys + k);
+        __m128 minD2 = _mm_set1_ps(FLT_MAX);
+        __m128i winding = _mm_setzero_si128();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            __m128 dx = _mm_set1_ps(e.dirX[i]);
+            __m128 dy = _mm_set1_ps(e.dirY[i]);
+            __m128 pax = _mm_sub_ps(px, _mm_set1_ps(e.originX[i]));
+            __m128 pay = _mm_sub_ps(py, _mm_set1_ps(e.originY[i]));
+
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(pax, dx), _mm_mul_ps(pay, dy)),
+                                  _mm_set1_ps(e.invLengthSq[i]));
+            t = _mm_min_ps(_mm_max_ps(t, zero), one);
+            __m128 ex = _mm_sub_ps(pax, _mm_mul_ps(dx, t));
+            __m128 ey = _mm_sub_ps(pay, _mm_mul_ps(dy, t));
+            minD2 = _mm_min_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), minD2);
+
+            // Winding: the row test differs per lane here
+            __m128 inRange = _mm_and_ps(_mm_cmpge_ps(py, _mm_set1_ps(e.minY[i])),
+                                        _mm_cmplt_ps(py, _mm_set1_ps(e.maxY[i])));
+            __m128 cross = _mm_sub_ps(_mm_mul_ps(dx, pay), _mm_mul_ps(pax, dy));
+            if (e.dirY[i] > 0)
+                winding = _mm_sub_epi32(winding, _mm_castps_si128(_mm_and_ps(inRange, _mm_cmpgt_ps(cross, zero))));
+            else
+                winding = _mm_add_epi32(winding, _mm_castps_si128(_mm_and_ps(inRange, _mm_cmplt_ps(cross, zero))));
+        }
+
+        __m128 dist = _mm_sqrt_ps(minD2);
+        __m128 outside = _mm_castsi128_ps(_mm_cmpeq_epi32(winding, _mm_setzero_si128()));
+        _mm_storeu_ps(out + k, _mm_xor_ps(dist, _mm_andnot_ps(outside, signBit)));
+    }
+
+    for (; k < count; k++)
+    {
+        Point2D p = {xs[k], ys[k]};
+        out[k] = calculatePreparedSDF(p, e);
+    }
+}
+
+/**
+ * @brief SSE2 unpack kernels, 16 / 8 samples per step
+ */
+static void unpackSDFCodes8SSE2(const unsigned char* codes, int count,
+                                float scale, float offset, float* out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vOffset = _mm_set1_ps(offset);
+
+    int k = 0;
+    for (; k + 16 <= count; k += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + k));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i words[4] = {
+            _mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+            _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero)
+        };
+        for (int j = 0; j < 4; j++)
+        {
+            __m128 values = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(words[j]), vScale), vOffset);
+            _mm_storeu_ps(out + k + 4 * j, values);
+        }
+    }
+    unpackSDFCodes8Scalar(codes + k, count - k, scale, offset, out + k);
+}
+
+static void unpackSDFCodes16SSE2(const unsigned short* codes, int count,
+                                 float scale, float offset, float* out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vOffset = _mm_set1_ps(offset);
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8)
+    {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + k));
+        __m128 low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+        __m128 high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero));
+        _mm_storeu_ps(out + k, _mm_add_ps(_mm_mul_ps(low, vScale), vOffset));
+        _mm_storeu_ps(out + k + 4, _mm_add_ps(_mm_mul_ps(high, vScale), vOffset));
+    }
+    unpackSDFCodes16Scalar(codes + k, count - k, scale, offset, out + k);
+}
+#endif
+
+#if SDF_HAVE_AVX
+/**
+ * @brief AVX2 row kernel, 8 pixels per edge step
+ */
+SDF_TARGET_AVX2
+static void computeSDFRowAVX2(const PreparedPolygon& e,
+                              float originX, float stepX, float py,
+                              int width, float* out,
+                              const unsigned char* insideRow)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 laneOffset = _mm256_set_ps(7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f);
+
+    const bool needWinding = (insideRow == nullptr);
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256 px = _mm256_add_ps(_mm256_set1_ps(originX),
+            _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset),
+                          _mm256_set1_ps(stepX)));
+        __m256 minD2 = _mm256_set1_ps(FLT_MAX);
+        __m256i winding = _mm256_setzero_si256();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m256 dx = _mm256_set1_ps(e.dirX[i]);
+            __m256 dy = _mm256_set1_ps(e.dirY[i]);
+            __m256 pax = _mm256_sub_ps(px, _mm256_set1_ps(e.originX[i]));
+
+            __m256 t = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_mul_ps(pax, dx), _mm256_set1_ps(payScalar * e.dirY[i])),
+                _mm256_set1_ps(e.invLengthSq[i]));
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            __m256 ex = _mm256_sub_ps(pax, _mm256_mul_ps(dx, t));
+            __m256 ey = _mm256_sub_ps(_mm256_set1_ps(payScalar), _mm256_mul_ps(dy, t));
+            minD2 = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)), minD2);
+
+            if (needWinding && py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m256 cross = _mm256_sub_ps(_mm256_set1_ps(e.dirX[i] * payScalar),
+                                             _mm256_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm256_sub_epi32(winding,
+                        _mm256_castps_si256(_mm256_cmp_ps(cross, zero, _CMP_GT_OQ)));
+                else
+                    winding = _mm256_add_epi32(winding,
+                        _mm256_castps_si256(_mm256_cmp_ps(cross, zero, _CMP_LT_OQ)));
+            }
+        }
+
+        __m256 dist = _mm256_sqrt_ps(minD2);
+        if (needWinding)
+        {
+            __m256 outside = _mm256_castsi256_ps(_mm256_cmpeq_epi32(winding, _mm256_setzero_si256()));
+            _mm256_storeu_ps(out + x, _mm256_xor_ps(dist, _mm256_andnot_ps(outside, signBit)));
+        }
+        else
+        {
+            _mm256_storeu_ps(out + x, dist);
+            applyMaskSigns(out + x, insideRow + x, 8);
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        out[x] = needWinding ? calculatePreparedSDF(p, e)
+                             : signedByMask(preparedDistance(p, e), insideRow[x]);
+    }
+}
+
+/**
+ * @brief AVX2 gradient row kernel, 8 pixels per edge step
+ */
+SDF_TARGET_AVX2
+static void computeSDFGradientRowAVX2(const PreparedPolygon& e,
+                                      float originX, float stepX, float py, int width,
+                                      float* distances, int distanceStride,
+                                      float* gradients, int gradientStride)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 laneOffset = _mm256_set_ps(7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f);
+    const float maxExtent = maxEdgeExtent(e);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256 px = _mm256_add_ps(_mm256_set1_ps(originX),
+            _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset),
+                          _mm256_set1_ps(stepX)));
+        __m256 minD2 = _mm256_set1_ps(FLT_MAX);
+        __m256 nearestX = zero;
+        __m256 nearestY = zero;
+        __m256i winding = _mm256_setzero_si256();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m256 dx = _mm256_set1_ps(e.dirX[i]);
+            __m256 dy = _mm256_set1_ps(e.dirY[i]);
+            __m256 pax = _mm256_sub_ps(px, _mm256_set1_ps(e.originX[i]));
+
+            __m256 t = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_mul_ps(pax, dx), _mm256_set1_ps(payScalar * e.dirY[i])),
+                _mm256_set1_ps(e.invLengthSq[i]));
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            __m256 ex = _mm256_sub_ps(pax, _mm256_mul_ps(dx, t));
+            __m256 ey = _mm256_sub_ps(_mm256_set1_ps(payScalar), _mm256_mul_ps(dy, t));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+
+            __m256 closer = _mm256_cmp_ps(d2, minD2, _CMP_LT_OQ);
+            minD2 = _mm256_min_ps(d2, minD2);
+            nearestX = _mm256_blendv_ps(nearestX, ex, closer);
+            nearestY = _mm256_blendv_ps(nearestY, ey, closer);
+
+            if (py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m256 cross = _mm256_sub_ps(_mm256_set1_ps(e.dirX[i] * payScalar),
+                                             _mm256_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm256_sub_epi32(winding,
+                        _mm256_castps_si256(_mm256_cmp_ps(cross, zero, _CMP_GT_OQ)));
+                else
+                    winding = _mm256_add_epi32(winding,
+                        _mm256_castps_si256(_mm256_cmp_ps(cross, zero, _CMP_LT_OQ)));
+            }
+        }
+
+        float dist[8], offsetX[8], offsetY[8];
+        int laneWinding[8];
+        _mm256_storeu_ps(dist, _mm256_sqrt_ps(minD2));
+        _mm256_storeu_ps(offsetX, nearestX);
+        _mm256_storeu_ps(offsetY, nearestY);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(laneWinding), winding);
+        storeGradientBlock(e, maxExtent, originX, stepX, py, x, 8, dist, offsetX, offsetY, laneWinding,
+                           distances, distanceStride, gradients, gradientStride);
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        storeGradientSample(e, p, distances + x * distanceStride, gradients + x * gradientStride);
+    }
+}
+
+/**
+ * @brief min/max/sqrt with an explicit (zeroing) merge source
+ *
+ * GCC's unmasked _mm512_min_ps/_mm512_max_ps/_mm512_sqrt_ps merge into
+ * _mm512_undefined_ps() and trip -Wmaybe-uninitialized; with a full mask
+ * the zeroing forms compile to the same instructions.
+ */
+SDF_TARGET_AVX512
+static inline __m512 min512(__m512 a, __m512 b)
+{
+    return _mm512_maskz_min_ps(0xFFFF, a, b);
+}
+
+SDF_TARGET_AVX512
+static inline __m512 max512(__m512 a, __m512 b)
+{
+    return _mm512_maskz_max_ps(0xFFFF, a, b);
+}
+
+SDF_TARGET_AVX512
+static inline __m512 sqrt512(__m512 a)
+{
+    return _mm512_maskz_sqrt_ps(0xFFFF, a);
+}
+
+/**
+ * @brief AVX-512 row kernel, 16 pixels per edge step
+ */
+SDF_TARGET_AVX512
+static void computeSDFRowAVX512(const PreparedPolygon& e,
+                                float originX, float stepX, float py,
+                                int width, float* out,
+                                const unsigned char* insideRow)
+{
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 laneOffset = _mm512_set_ps(15.5f, 14.5f, 13.5f, 12.5f, 11.5f, 10.5f, 9.5f, 8.5f,
+                                            7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f);
+    const __m512i allOnes = _mm512_set1_epi32(1);
+    const __m512i signBit = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+
+    const bool needWinding = (insideRow == nullptr);
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m512 px = _mm512_add_ps(_mm512_set1_ps(originX),
+            _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps(static_cast<float>(x)), laneOffset),
+                          _mm512_set1_ps(stepX)));
+        __m512 minD2 = _mm512_set1_ps(FLT_MAX);
+        __m512i winding = _mm512_setzero_si512();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m512 dx = _mm512_set1_ps(e.dirX[i]);
+            __m512 dy = _mm512_set1_ps(e.dirY[i]);
+            __m512 pax = _mm512_sub_ps(px, _mm512_set1_ps(e.originX[i]));
+
+            __m512 t = _mm512_mul_ps(
+                _mm512_add_ps(_mm512_mul_ps(pax, dx), _mm512_set1_ps(payScalar * e.dirY[i])),
+                _mm512_set1_ps(e.invLengthSq[i]));
+            t = min512(max512(t, zero), one);
+            __m512 ex = _mm512_sub_ps(pax, _mm512_mul_ps(dx, t));
+            __m512 ey = _mm512_sub_ps(_mm512_set1_ps(payScalar), _mm512_mul_ps(dy, t));
+            minD2 = min512(_mm512_add_ps(_mm512_mul_ps(ex, ex), _mm512_mul_ps(ey, ey)), minD2);
+
+            if (needWinding && py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m512 cross = _mm512_sub_ps(_mm512_set1_ps(e.dirX[i] * payScalar),
+                                             _mm512_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm512_mask_add_epi32(winding,
+                        _mm512_cmp_ps_mask(cross, zero, _CMP_GT_OQ), winding, allOnes);
+                else
+                    winding = _mm512_mask_sub_epi32(winding,
+                        _mm512_cmp_ps_mask(cross, zero, _CMP_LT_OQ), winding, allOnes);
+            }
+        }
+
+        __m512 dist = sqrt512(minD2);
+        if (needWinding)
+        {
+            __mmask16 inside = _mm512_cmpneq_epi32_mask(winding, _mm512_setzero_si512());
+            __m512i bits = _mm512_castps_si512(dist);
+            bits = _mm512_mask_xor_epi32(bits, inside, bits, signBit);
+            _mm512_storeu_ps(out + x, _mm512_castsi512_ps(bits));
+        }
+        else
+        {
+            _mm512_storeu_ps(out + x, dist);
+            applyMaskSigns(out + x, insideRow + x, 16);
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        out[x] = needWinding ? calculatePreparedSDF(p, e)
+                             : signedByMask(preparedDistance(p, e), insideRow[x]);
+    }
+}
+
+/**
+ * @brief AVX-512 gradient row kernel, 16 pixels per edge step
+ */
+SDF_TARGET_AVX512
+static void computeSDFGradientRowAVX512(const PreparedPolygon& e,
+                                        float originX, float stepX, float py, int width,
+                                        float* distances, int distanceStride,
+                                        float* gradients, int gradientStride)
+{
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 laneOffset = _mm512_set_ps(15.5f, 14.5f, 13.5f, 12.5f, 11.5f, 10.5f, 9.5f, 8.5f,
+                                            7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f);
+    const __m512i allOnes = _mm512_set1_epi32(1);
+    const float maxExtent = maxEdgeExtent(e);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m512 px = _mm512_add_ps(_mm512_set1_ps(originX),
+            _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps(static_cast<float>(x)), laneOffset),
+                          _mm512_set1_ps(stepX)));
+        __m512 minD2 = _mm512_set1_ps(FLT_MAX);
+        __m512 nearestX = zero;
+        __m512 nearestY = zero;
+        __m512i winding = _mm512_setzero_si512();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            float payScalar = py - e.originY[i];
+            __m512 dx = _mm512_set1_ps(e.dirX[i]);
+            __m512 dy = _mm512_set1_ps(e.dirY[i]);
+            __m512 pax = _mm512_sub_ps(px, _mm512_set1_ps(e.originX[i]));
+
+            __m512 t = _mm512_mul_ps(
+                _mm512_add_ps(_mm512_mul_ps(pax, dx), _mm512_set1_ps(payScalar * e.dirY[i])),
+                _mm512_set1_ps(e.invLengthSq[i]));
+            t = min512(max512(t, zero), one);
+            __m512 ex = _mm512_sub_ps(pax, _mm512_mul_ps(dx, t));
+            __m512 ey = _mm512_sub_ps(_mm512_set1_ps(payScalar), _mm512_mul_ps(dy, t));
+            __m512 d2 = _mm512_add_ps(_mm512_mul_ps(ex, ex), _mm512_mul_ps(ey, ey));
+
+            __mmask16 closer = _mm512_cmp_ps_mask(d2, minD2, _CMP_LT_OQ);
+            minD2 = min512(d2, minD2);
+            nearestX = _mm512_mask_blend_ps(closer, nearestX, ex);
+            nearestY = _mm512_mask_blend_ps(closer, nearestY, ey);
+
+            if (py >= e.minY[i] && py < e.maxY[i])
+            {
+                __m512 cross = _mm512_sub_ps(_mm512_set1_ps(e.dirX[i] * payScalar),
+                                             _mm512_mul_ps(pax, dy));
+                if (e.dirY[i] > 0)
+                    winding = _mm512_mask_add_epi32(winding,
+                        _mm512_cmp_ps_mask(cross, zero, _CMP_GT_OQ), winding, allOnes);
+                else
+                    winding = _mm512_mask_sub_epi32(winding,
+                        _mm512_cmp_ps_mask(cross, zero, _CMP_LT_OQ), winding, allOnes);
+            }
+        }
+
+        float dist[16], offsetX[16], offsetY[16];
+        int laneWinding[16];
+        _mm512_storeu_ps(dist, sqrt512(minD2));
+        _mm512_storeu_ps(offsetX, nearestX);
+        _mm512_storeu_ps(offsetY, nearestY);
+        _mm512_storeu_si512(laneWinding, winding);
+        storeGradientBlock(e, maxExtent, originX, stepX, py, x, 16, dist, offsetX, offsetY, laneWinding,
+                           distances, distanceStride, gradients, gradientStride);
+    }
+
+    for (; x < width; x++)
+    {
+        Point2D p = {originX + (x + 0.5f) * stepX, py};
+        storeGradientSample(e, p, distances + x * distanceStride, gradients + x * gradientStride);
+    }
+}
+
+/**
+ * @brief AVX2 points kernel, 8 points per edge step
+ */
+SDF_TARGET_AVX2
+static void computeSDFPointsAVX2(const PreparedPolygon& e,
+                                 const float* xs, const float* ys,
+                                 int count, float* out)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8)
+    {
+        __m256 px = _mm256_loadu_ps(xs + k);
+        __m256 py = _mm256_loadu_ps(ys + k);
+        __m256 minD2 = _mm256_set1_ps(FLT_MAX);
+        __m256i winding = _mm256_setzero_si256();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            __m256 dx = _mm256_set1_ps(e.dirX[i]);
+            __m256 dy = _mm256_set1_ps(e.dirY[i]);
+            __m256 pax = _mm256_sub_ps(px, _mm256_set1_ps(e.originX[i]));
+            __m256 pay = _mm256_sub_ps(py, _mm256_set1_ps(e.originY[i]));
+
+            __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(pax, dx), _mm256_mul_ps(pay, dy)),
+                                     _mm256_set1_ps(e.invLengthSq[i]));
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            __m256 ex = _mm256_sub_ps(pax, _mm256_mul_ps(dx, t));
+            __m256 ey = _mm256_sub_ps(pay, _mm256_mul_ps(dy, t));
+            minD2 = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)), minD2);
+
+            __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(py, _mm256_set1_ps(e.minY[i]), _CMP_GE_OQ),
+                                           _mm256_cmp_ps(py, _mm256_set1_ps(e.maxY[i]), _CMP_LT_OQ));
+            __m256 cross = _mm256_sub_ps(_mm256_mul_ps(dx, pay), _mm256_mul_ps(pax, dy));
+            if (e.dirY[i] > 0)
+                winding = _mm256_sub_epi32(winding, _mm256_castps_si256(
+                    _mm256_and_ps(inRange, _mm256_cmp_ps(cross, zero, _CMP_GT_OQ))));
+            else
+                winding = _mm256_add_epi32(winding, _mm256_castps_si256(
+                    _mm256_and_ps(inRange, _mm256_cmp_ps(cross, zero, _CMP_LT_OQ))));
+        }
+
+        __m256 dist = _mm256_sqrt_ps(minD2);
+        __m256 outside = _mm256_castsi256_ps(_mm256_cmpeq_epi32(winding, _mm256_setzero_si256()));
+        _mm256_storeu_ps(out + k, _mm256_xor_ps(dist, _mm256_andnot_ps(outside, signBit)));
+    }
+
+    for (; k < count; k++)
+    {
+        Point2D p = {xs[k], ys[k]};
+        out[k] = calculatePreparedSDF(p, e);
+    }
+}
+
+/**
+ * @brief AVX-512 points kernel, 16 points per edge step
+ */
+SDF_TARGET_AVX512
+static void computeSDFPointsAVX512(const PreparedPolygon& e,
+                                   const float* xs, const float* ys,
+                                   int count, float* out)
+{
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512i allOnes = _mm512_set1_epi32(1);
+    const __m512i signBit = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+
+    int k = 0;
+    for (; k + 16 <= count; k += 16)
+    {
+        __m512 px = _mm512_loadu_ps(xs + k);
+        __m512 py = _mm512_loadu_ps(ys + k);
+        __m512 minD2 = _mm512_set1_ps(FLT_MAX);
+        __m512i winding = _mm512_setzero_si512();
+
+        for (int i = 0; i < e.edgeCount; i++)
+        {
+            __m512 dx = _mm512_set1_ps(e.dirX[i]);
+            __m512 dy = _mm512_set1_ps(e.dirY[i]);
+            __m512 pax = _mm512_sub_ps(px, _mm512_set1_ps(e.originX[i]));
+            __m512 pay = _mm512_sub_ps(py, _mm512_set1_ps(e.originY[i]));
+
+            __m512 t = _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(pax, dx), _mm512_mul_ps(pay, dy)),
+                                     _mm512_set1_ps(e.invLengthSq[i]));
+            t = min512(max512(t, zero), one);
+            __m512 ex = _mm512_sub_ps(pax, _mm512_mul_ps(dx, t));
+            __m512 ey = _mm512_sub_ps(pay, _mm512_mul_ps(dy, t));
+            minD2 = min512(_mm512_add_ps(_mm512_mul_ps(ex, ex), _mm512_mul_ps(ey, ey)), minD2);
+
+            __mmask16 inRange = _mm512_cmp_ps_mask(py, _mm512_set1_ps(e.minY[i]), _CMP_GE_OQ) &
+                                _mm512_cmp_ps_mask(py, _mm512_set1_ps(e.maxY[i]), _CMP_LT_OQ);
+            __m512 cross = _mm512_sub_ps(_mm512_mul_ps(dx, pay), _mm512_mul_ps(pax, dy));
+            if (e.dirY[i] > 0)
+                winding = _mm512_mask_add_epi32(winding,
+                    inRange & _mm512_cmp_ps_mask(cross, zero, _CMP_GT_OQ), winding, allOnes);
+            else
+                winding = _mm512_mask_sub_epi32(winding,
+                    inRange & _mm512_cmp_ps_mask(cross, zero, _CMP_LT_OQ), winding, allOnes);
+        }
+
+        __m512 dist = sqrt512(minD2);
+        __mmask16 inside = _mm512_cmpneq_epi32_mask(winding, _mm512_setzero_si512());
+        __m512i bits = _mm512_castps_si512(dist);
+        bits = _mm512_mask_xor_epi32(bits, inside, bits, signBit);
+        _mm512_storeu_ps(out + k, _mm512_castsi512_ps(bits));
+    }
+
+    for (; k < count; k++)
+    {
+        Point2D p = {xs[k], ys[k]};
+        out[k] = calculatePreparedSDF(p, e);
+    }
+}
+
+/**
+ * @brief AVX2 unpack kernels, 8 samples per step
+ */
+SDF_TARGET_AVX2
+static void unpackSDFCodes8AVX2(const unsigned char* codes, int count,
+                                float scale, float offset, float* out)
+{
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vOffset = _mm256_set1_ps(offset);
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8)
+    {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + k));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        _mm256_storeu_ps(out + k, _mm256_add_ps(_mm256_mul_ps(values, vScale), vOffset));
+    }
+    unpackSDFCodes8Scalar(codes + k, count - k, scale, offset, out + k);
+}
+
+SDF_TARGET_AVX2
+static void unpackSDFCodes16AVX2(const unsigned short* codes, int count,
+                                 float scale, float offset, float* out)
+{
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vOffset = _mm256_set1_ps(offset);
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8)
+    {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + k));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(words));
+        _mm256_storeu_ps(out + k, _mm256_add_ps(_mm256_mul_ps(values, vScale), vOffset));
+    }
+    unpackSDFCodes16Scalar(codes + k, count - k, scale, offset, out + k);
+}
+
+enum CPUFeatureLevel { CPU_SSE2, CPU_AVX2, CPU_AVX512 };
+
+/**
+ * @brief Detect the widest vector ISA usable by both CPU and OS
+ */
+static CPUFeatureLevel detectCPUFeatureLevel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    if (maxLeaf < 7)
+        return CPU_SSE2;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return CPU_SSE2;
+
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)  // XMM and YMM state
+        return CPU_SSE2;
+
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    bool avx512f = (info[1] & (1 << 16)) != 0;
+    if (avx512f && (xcr0 & 0xe6) == 0xe6)  // Opmask and ZMM state
+        return CPU_AVX512;
+    return avx2 ? CPU_AVX2 : CPU_SSE2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return CPU_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return CPU_AVX2;
+    return CPU_SSE2;
+#endif
+}
+#endif
+
+SDFRowKernel getSDFRowKernel()
+{
+#if SDF_HAVE_AVX
+    static const CPUFeatureLevel level = detectCPUFeatureLevel();
+    if (level == CPU_AVX512)
+        return computeSDFRowAVX512;
+    if (level == CPU_AVX2)
+        return computeSDFRowAVX2;
+#endif
+#if SDF_HAVE_SSE2
+    return computeSDFRowSSE2;
+#else
+    return computeSDFRowScalar;
+#endif
+}
+
+const char* getSDFRowKernelName()
+{
+#if SDF_HAVE_AVX
+    SDFRowKernel kernel = getSDFRowKernel();
+    if (kernel == computeSDFRowAVX512)
+        return "AVX-512";
+    if (kernel == computeSDFRowAVX2)
+        return "AVX2";
+#endif
+#if SDF_HAVE_SSE2
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+SDFGradientRowKernel getSDFGradientRowKernel()
+{
+#if SDF_HAVE_AVX
+    static const CPUFeatureLevel level = detectCPUFeatureLevel();
+    if (level == CPU_AVX512)
+        return computeSDFGradientRowAVX512;
+    if (level == CPU_AVX2)
+        return computeSDFGradientRowAVX2;
+#endif
+#if SDF_HAVE_SSE2
+    return computeSDFGradientRowSSE2;
+#else
+    return computeSDFGradientRowScalar;
+#endif
+}
+
+SDFPointsKernel getSDFPointsKernel()
+{
+#if SDF_HAVE_AVX
+    static const CPUFeatureLevel level = detectCPUFeatureLevel();
+    if (level == CPU_AVX512)
+        return computeSDFPointsAVX512;
+    if (level == CPU_AVX2)
+        return computeSDFPointsAVX2;
+#endif
+#if SDF_HAVE_SSE2
+    return computeSDFPointsSSE2;
+#else
+    return computeSDFPointsScalar;
+#endif
+}
+
+SDFUnpack8Kernel getSDFUnpack8Kernel()
+{
+#if SDF_HAVE_AVX
+    static const CPUFeatureLevel level = detectCPUFeatureLevel();
+    if (level != CPU_SSE2)
+        return unpackSDFCodes8AVX2;
+#endif
+#if SDF_HAVE_SSE2
+    return unpackSDFCodes8SSE2;
+#else
+    return unpackSDFCodes8Scalar;
+#endif
+}
+
+SDFUnpack16Kernel getSDFUnpack16Kernel()
+{
+#if SDF_HAVE_AVX
+    static const CPUFeatureLevel level = detectCPUFeatureLevel();
+    if (level != CPU_SSE2)
+        return unpackSDFCodes16AVX2;
+#endif
+#if SDF_HAVE_SSE2
+    return unpackSDFCodes16SSE2;
+#else
+    return unpackSDFCodes16Scalar;
+#endif
+}
@@ -0,0 +1,127 @@
+#ifndef SDF_SIMD_H
+#define SDF_SIMD_H
+
+#include "sdf.h"
+
+/**
+ * @file sdf_simd.h
+ * @brief Internal vectorized SDF row kernels (not part of the public API)
+ *
+ * A row kernel evaluates one grid row against every edge of a
+ * PreparedPolygon; a points kernel does the same for arbitrary points.
+ * Pixels are processed in blocks of 4/8/16 lanes; for each block the
+ * minimum squared distance and the winding number stay in registers while
+ * the edges are streamed, and the sqrt and sign are applied once per pixel
+ * at the end.
+ *
+ * Every lane performs the same float operations in the same order as
+ * calculatePreparedSDF(), so all kernels produce bit-identical output.
+ */
+
+/**
+ * @brief Row kernel signature
+ *
+ * Pixel x of the row is sampled at (originX + (x + 0.5f) * stepX, py).
+ * The prepared polygon must have at least 3 edges.
+ * If insideRow is given (width bytes, 1 = inside, e.g. from the scanline
+ * sign pass) the kernel only computes distances and takes the signs from
+ * it; otherwise the winding number is accumulated with the distances.
+ */
+typedef void (*SDFRowKernel)(const PreparedPolygon& prepared,
+                             float originX, float stepX, float py,
+                             int width, float* out,
+                             const unsigned char* insideRow);
+
+/**
+ * @brief Scalar reference row kernel
+ */
+void computeSDFRowScalar(const PreparedPolygon& prepared,
+                         float originX, float stepX, float py,
+                         int width, float* out,
+                         const unsigned char* insideRow);
+
+/**
+ * @brief Best row kernel for the running CPU (selected once, then cached)
+ */
+SDFRowKernel getSDFRowKernel();
+
+/**
+ * @brief Name of the kernel returned by getSDFRowKernel()
+ */
+const char* getSDFRowKernelName();
+
+/**
+ * @brief Gradient row kernel signature
+ *
+ * Same samples as SDFRowKernel; pixel x gets the values of
+ * calculatePreparedSDFGradient(), the distance at distances[x * distanceStride]
+ * and the gradient at gradients[x * gradientStride] (x, then y).
+ * The prepared polygon must have at least 3 edges.
+ */
+typedef void (*SDFGradientRowKernel)(const PreparedPolygon& prepared,
+                                     float originX, float stepX, float py, int width,
+                                     float* distances, int distanceStride,
+                                     float* gradients, int gradientStride);
+
+/**
+ * @brief Scalar reference gradient row kernel
+ */
+void computeSDFGradientRowScalar(const PreparedPolygon& prepared,
+                                 float originX, float stepX, float py, int width,
+                                 float* distances, int distanceStride,
+                                 float* gradients, int gradientStride);
+
+/**
+ * @brief Best gradient row kernel for the running CPU (same ISA as getSDFRowKernel())
+ */
+SDFGradientRowKernel getSDFGradientRowKernel();
+
+/**
+ * @brief Points kernel signature
+ *
+ * Evaluates count arbitrary points (xs[k], ys[k]), one point per lane, with
+ * the same float operations as calculatePreparedSDF().
+ * The prepared polygon must have at least 3 edges.
+ */
+typedef void (*SDFPointsKernel)(const PreparedPolygon& prepared,
+                                const float* xs, const float* ys,
+                                int count, float* out);
+
+/**
+ * @brief Scalar reference points kernel
+ */
+void computeSDFPointsScalar(const PreparedPolygon& prepared,
+                            const float* xs, const float* ys,
+                            int count, float* out);
+
+/**
+ * @brief Best points kernel for the running CPU (same ISA as getSDFRowKernel())
+ */
+SDFPointsKernel getSDFPointsKernel();
+
+/**
+ * @brief Unpack kernel signatures for quantized grids
+ *
+ * Sample k becomes codes[k] * scale + offset (one multiply and one add per
+ * sample, no fused multiply-add), so every kernel gives the same floats.
+ */
+typedef void (*SDFUnpack8Kernel)(const unsigned char* codes, int count,
+                                 float scale, float offset, float* out);
+typedef void (*SDFUnpack16Kernel)(const unsigned short* codes, int count,
+                                  float scale, float offset, float* out);
+
+/**
+ * @brief Scalar reference unpack kernels
+ */
+void unpackSDFCodes8Scalar(const unsigned char* codes, int count,
+                           float scale, float offset, float* out);
+void unpackSDFCodes16Scalar(const unsigned short* codes, int count,
+                            float scale, float offset, float* out);
+
+/**
+ * @brief Best unpack kernels for the running CPU
+ */
+SDFUnpack8Kernel getSDFUnpack8Kernel();
+SDFUnpack16Kernel getSDFUnpack16Kernel();
+
+#endif // SDF_SIMD_H
@@ -0,0 +1,393 @@
+#include "sdf_backends.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file sdf_trace.cpp
+ * @brief Marching Squares by contour tracing
+ *
+ * Cells are scanned for a crossing cell that has not been visited; from
+ * there the contour is followed cell to cell through the edge it leaves
+ * by. Each crossing point is computed once per grid edge, from that edge's
+ * two samples, so consecutive segments share their vertex exactly.
+ * Several levels are traced after one sweep that collects, per level, the
+ * cells whose value range contains it.
+ *
+ * With several threads the seed scan, which touches every cell, runs in
+ * row bands; the bands' seeds are concatenated in row order and traced on
+ * the calling thread, so the result does not depend on the thread count.
+ */
+
+// Oriented version of the Marching Squares table (see sdf_backends.h).
+// Segments are oriented with the side above isoValue on the right; saddles
+// (5, 10) are split as in extractIsoContour().
+const int TRACE_NEXT[16][4] = {
+    {-1, -1, -1, -1},  // Case 0
+    {-1, -1, -1,  0},  // Case 1
+    { 1, -1, -1, -1},  // Case 2
+    {-1, -1, -1,  1},  // Case 3
+    {-1,  2, -1, -1},  // Case 4
+    {-1,  2, -1,  0},  // Case 5
+    { 2, -1, -1, -1},  // Case 6
+    {-1, -1, -1,  2},  // Case 7
+    {-1, -1,  3, -1},  // Case 8
+    {-1, -1,  0, -1},  // Case 9
+    { 1, -1,  3, -1},  // Case 10
+    {-1, -1,  1, -1},  // Case 11
+    {-1,  3, -1, -1},  // Case 12
+    {-1,  0, -1, -1},  // Case 13
+    { 3, -1, -1, -1},  // Case 14
+    {-1, -1, -1, -1}   // Case 15
+};
+
+// Neighbor across each edge, and the same edge seen from the neighbor
+static const int EDGE_DX[4] = {0, 1, 0, -1};
+static const int EDGE_DY[4] = {-1, 0, 1, 0};
+static const int OPPOSITE_EDGE[4] = {2, 3, 0, 1};
+
+namespace
+{
+
+/**
+ * @brief Grid and cell layout shared by the tracing helpers
+ */
+struct TraceGrid {
+    const float* data;
+    int width;
+    int cellsX, cellsY;
+    float minX, minY;
+    float cellWidth, cellHeight;  // Same cell layout as extractIsoContour()
+};
+
+} // namespace
+
+static int cellCase(const TraceGrid& grid, float isoValue, int x, int y)
+{
+    const float* bottom = grid.data + y * grid.width + x;
+    const float* top = bottom + grid.width;
+    return ((bottom[0] > isoValue) ? 1 : 0) | ((bottom[1] > isoValue) ? 2 : 0) |
+           ((top[1] > isoValue) ? 4 : 0) | ((top[0] > isoValue) ? 8 : 0);
+}
+
+/**
+ * @brief Crossing point on one edge of cell (x, y)
+ */
+static Point2D edgePoint(const TraceGrid& grid, float isoValue, int x, int y, int edge)
+{
+    const float* bottom = grid.data + y * grid.width + x;
+    const float* top = bottom + grid.width;
+    float x0 = grid.minX + x * grid.cellWidth, x1 = grid.minX + (x + 1) * grid.cellWidth;
+    float y0 = grid.minY + y * grid.cellHeight, y1 = grid.minY + (y + 1) * grid.cellHeight;
+    return traceEdgePoint(bottom, top, x0, x1, y0, y1, isoValue, edge);
+}
+
+/**
+ * @brief Trace every not yet visited contour through crossing cell (sx, sy)
+ *
+ * visited holds one bit per entry edge and cell: saddle cells hold two
+ * segments.
+ */
+static void traceFromCell(const TraceGrid& grid, float isoValue, int sx, int sy,
+                          std::vector<unsigned char>& visited,
+                          std::vector<IsoContour>& contours)
+{
+    const int cellsX = grid.cellsX;
+    const int cellsY = grid.cellsY;
+    const int seedCase = cellCase(grid, isoValue, sx, sy);
+
+    for (int seedEntry = 0; seedEntry < 4; seedEntry++)
+    {
+        if (TRACE_NEXT[seedCase][seedEntry] < 0 ||
+            (visited[sy * cellsX + sx] & (1 << seedEntry)))
+        {
+            continue;
+        }
+
+        IsoContour contour;
+        contour.closed = false;
+        contour.points.push_back(edgePoint(grid, isoValue, sx, sy, seedEntry));
+
+        // Forward until the contour closes or leaves the grid
+        int x = sx, y = sy, entry = seedEntry;
+        while (true)
+        {
+            visited[y * cellsX + x] |= static_cast<unsigned char>(1 << entry);
+            int exit = TRACE_NEXT[cellCase(grid, isoValue, x, y)][entry];
+            int nx = x + EDGE_DX[exit];
+            int ny = y + EDGE_DY[exit];
+            int nextEntry = OPPOSITE_EDGE[exit];
+
+            if (nx == sx && ny == sy && nextEntry == seedEntry)
+            {
+                contour.closed = true;
+                break;
+            }
+
+            contour.points.push_back(edgePoint(grid, isoValue, x, y, exit));
+            if (nx < 0 || ny < 0 || nx >= cellsX || ny >= cellsY)
+                break;
+
+            x = nx;
+            y = ny;
+            entry = nextEntry;
+        }
+
+        if (!contour.closed)
+        {
+            // Open chain: collect the part before the seed, back to
+            // the grid border
+            std::vector<Point2D> head;
+            x = sx + EDGE_DX[seedEntry];
+            y = sy + EDGE_DY[seedEntry];
+            int exit = OPPOSITE_EDGE[seedEntry];
+            while (x >= 0 && y >= 0 && x < cellsX && y < cellsY)
+            {
+                const int* next = TRACE_NEXT[cellCase(grid, isoValue, x, y)];
+                int previousEntry = -1;
+                for (int e = 0; e < 4; e++)
+                {
+                    if (next[e] == exit)
+                        previousEntry = e;
+                }
+                if (previousEntry < 0)
+                    break;
+
+                visited[y * cellsX + x] |= static_cast<unsigned char>(1 << previousEntry);
+                head.push_back(edgePoint(grid, isoValue, x, y, previousEntry));
+                exit = OPPOSITE_EDGE[previousEntry];
+                x += EDGE_DX[previousEntry];
+                y += EDGE_DY[previousEntry];
+            }
+
+            if (!head.empty())
+            {
+                std::reverse(head.begin(), head.end());
+                contour.points.insert(contour.points.begin(), head.begin(), head.end());
+            }
+        }
+
+        contours.push_back(contour);
+    }
+}
+
+static TraceGrid makeTraceGrid(const float* sdfData, int width, int height,
+                               float worldMinX, float worldMaxX,
+                               float worldMinY, float worldMaxY)
+{
+    TraceGrid grid;
+    grid.data = sdfData;
+    grid.width = width;
+    grid.cellsX = width - 1;
+    grid.cellsY = height - 1;
+    grid.minX = worldMinX;
+    grid.minY = worldMinY;
+    grid.cellWidth = (worldMaxX - worldMinX) / (width - 1);
+    grid.cellHeight = (worldMaxY - worldMinY) / (height - 1);
+    return grid;
+}
+
+/**
+ * @brief Call visit(x, y) for every crossing cell of rows [rowBegin, rowEnd),
+ *        in row-major order
+ */
+template <typename Visit>
+static void scanCrossingCells(const TraceGrid& grid, float isoValue,
+                              int rowBegin, int rowEnd, Visit visit)
+{
+    const int width = grid.width;
+    const int cellsX = grid.cellsX;
+
+    // Per-row "above" flags, 8 cells per step: a cell is crossed iff its
+    // flags differ horizontally or vertically. Rows are padded so that
+    // 8-byte loads at x + 1 stay inside.
+    std::vector<unsigned char> bottomAbove(width + 8, 0), topAbove(width + 8, 0);
+    const float* firstRow = grid.data + rowBegin * width;
+    for (int x = 0; x < width; x++)
+        topAbove[x] = (firstRow[x] > isoValue) ? 1 : 0;
+
+    for (int sy = rowBegin; sy < rowEnd; sy++)
+    {
+        bottomAbove.swap(topAbove);
+        const float* topRow = grid.data + (sy + 1) * width;
+        for (int x = 0; x < width; x++)
+            topAbove[x] = (topRow[x] > isoValue) ? 1 : 0;
+
+        for (int sx = 0; sx < cellsX; sx++)
+        {
+            if ((sx & 7) == 0 && sx + 8 <= cellsX)
+            {
+                uint64_t b0, b1, t0, t1;
+                std::memcpy(&b0, &bottomAbove[sx], 8);
+                std::memcpy(&b1, &bottomAbove[sx + 1], 8);
+                std::memcpy(&t0, &topAbove[sx], 8);
+                std::memcpy(&t1, &topAbove[sx + 1], 8);
+                if (((b0 ^ b1) | (b0 ^ t0) | (t0 ^ t1)) == 0)
+                {
+                    sx += 7;
+                    continue;
+                }
+            }
+
+            if (bottomAbove[sx] == bottomAbove[sx + 1] && bottomAbove[sx] == topAbove[sx] &&
+                topAbove[sx] == topAbove[sx + 1])
+            {
+                continue;
+            }
+
+            visit(sx, sy);
+        }
+    }
+}
+
+/**
+ * @brief Row bands for a parallel seed scan: several per thread, as
+ *        contour cells are unevenly spread
+ */
+static int seedBandRows(int cellRows, int threads)
+{
+    return std::max(1, cellRows / (threads * 4));
+}
+
+std::vector<IsoContour> traceIsoContours(const float* sdfData,
+                                         int width, int height,
+                                         float worldMinX, float worldMaxX,
+                                         float worldMinY, float worldMaxY,
+                                         float isoValue,
+                                         int threadCount)
+{
+    std::vector<IsoContour> contours;
+
+    if (sdfData == nullptr || width < 2 || height < 2)
+        return contours;
+
+    const TraceGrid grid = makeTraceGrid(sdfData, width, height,
+                                         worldMinX, worldMaxX, worldMinY, worldMaxY);
+    const int cellsX = grid.cellsX;
+    const int cellsY = grid.cellsY;
+    std::vector<unsigned char> visited(static_cast<size_t>(cellsX) * cellsY, 0);
+
+    const int threads = ThreadPool::resolveThreadCount(threadCount);
+    if (threads <= 1 || cellsY < 2)
+    {
+        // Trace as seeds are found
+        scanCrossingCells(grid, isoValue, 0, cellsY, [&](int sx, int sy)
+        {
+            traceFromCell(grid, isoValue, sx, sy, visited, contours);
+        });
+    }
+    else
+    {
+        const int rowsPerBand = seedBandRows(cellsY, threads);
+        const int bandCount = (cellsY + rowsPerBand - 1) / rowsPerBand;
+        std::vector<std::vector<int> > bandSeeds(bandCount);
+        ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+        {
+            const int rowBegin = band * rowsPerBand;
+            std::vector<int>& seeds = bandSeeds[band];
+            scanCrossingCells(grid, isoValue, rowBegin, std::min(cellsY, rowBegin + rowsPerBand),
+                              [&](int sx, int sy)
+            {
+                seeds.push_back(sy * cellsX + sx);
+            });
+        });
+
+        for (int band = 0; band < bandCount; band++)
+        {
+            const std::vector<int>& seeds = bandSeeds[band];
+            for (size_t k = 0; k < seeds.size(); k++)
+                traceFromCell(grid, isoValue, seeds[k] % cellsX, seeds[k] / cellsX, visited, contours);
+        }
+    }
+
+    buildContourHierarchy(contours);
+    return contours;
+}
+
+std::vector<std::vector<IsoContour> > traceIsoContours(const float* sdfData,
+                                                       int width, int height,
+                                                       float worldMinX, float worldMaxX,
+                                                       float worldMinY, float worldMaxY,
+                                                       const std::vector<float>& isoValues,
+                                                       int threadCount)
+{
+    const int levelCount = static_cast<int>(isoValues.size());
+    std::vector<std::vector<IsoContour> > levelContours(levelCount);
+
+    if (sdfData == nullptr || width < 2 || height < 2 || levelCount == 0 ||
+        !std::is_sorted(isoValues.begin(), isoValues.end()))
+    {
+        return levelContours;
+    }
+
+    const TraceGrid grid = makeTraceGrid(sdfData, width, height,
+                                         worldMinX, worldMaxX, worldMinY, worldMaxY);
+    const int cellsX = grid.cellsX;
+    const int cellsY = grid.cellsY;
+
+    // One sweep: each cell is loaded once and its value range selects the
+    // levels crossing it; their seed lists come out in row-major order
+    auto sweepRows = [&](int rowBegin, int rowEnd, std::vector<std::vector<int> >& seeds)
+    {
+        seeds.resize(levelCount);
+        for (int y = rowBegin; y < rowEnd; y++)
+        {
+            const float* bottom = sdfData + y * width;
+            const float* top = bottom + width;
+            for (int x = 0; x < cellsX; x++)
+            {
+                float lo = std::min(std::min(bottom[x], bottom[x + 1]), std::min(top[x], top[x + 1]));
+                float hi = std::max(std::max(bottom[x], bottom[x + 1]), std::max(top[x], top[x + 1]));
+                int first = crossingLevelBegin(isoValues, lo);
+                int last = crossingLevelBegin(isoValues, hi);
+                for (int level = first; level < last; level++)
+                    seeds[level].push_back(y * cellsX + x);
+            }
+        }
+    };
+
+    std::vector<std::vector<int> > levelSeeds;
+    const int threads = ThreadPool::resolveThreadCount(threadCount);
+    if (threads <= 1 || cellsY < 2)
+    {
+        sweepRows(0, cellsY, levelSeeds);
+    }
+    else
+    {
+        const int rowsPerBand = seedBandRows(cellsY, threads);
+        const int bandCount = (cellsY + rowsPerBand - 1) / rowsPerBand;
+        std::vector<std::vector<std::vector<int> > > bandSeeds(bandCount);
+        ThreadPool::shared().parallelFor(bandCount, threads, [&](int band)
+        {
+            const int rowBegin = band * rowsPerBand;
+            sweepRows(rowBegin, std::min(cellsY, rowBegin + rowsPerBand), bandSeeds[band]);
+        });
+
+        // Concatenated in band order: row-major, as the single sweep
+        levelSeeds.resize(levelCount);
+        for (int level = 0; level < levelCount; level++)
+        {
+            for (int band = 0; band < bandCount; band++)
+                levelSeeds[level].insert(levelSeeds[level].end(),
+                                         bandSeeds[band][level].begin(), bandSeeds[band][level].end());
+        }
+    }
+
+    // Trace level by level from the seeds, as traceIsoContours() would;
+    // the visited flags are cleared again on just the seed cells
+    std::vector<unsigned char> visited(static_cast<size_t>(cellsX) * cellsY, 0);
+    for (int level = 0; level < levelCount; level++)
+    {
+        const std::vector<int>& seeds = levelSeeds[level];
+        for (size_t k = 0; k < seeds.size(); k++)
+            traceFromCell(grid, isoValues[level], seeds[k] % cellsX, seeds[k] / cellsX,
+                          visited, levelContours[level]);
+        for (size_t k = 0; k < seeds.size(); k++)
+            visited[seeds[k]] = 0;
+
+        buildContourHierarchy(levelContours[level]);
+    }
+
+    return levelContours;
+}